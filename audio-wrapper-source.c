@@ -1,6 +1,8 @@
 
 #include <obs-module.h>
+#include <util/platform.h>
 #include "audio-wrapper-source.h"
+#include "metrics-ring.h"
 
 const char *audio_wrapper_get_name(void *type_data)
 {
@@ -21,6 +23,23 @@ void audio_wrapper_destroy(void *data)
 	bfree(data);
 }
 
+void audio_wrapper_mix(struct obs_source_audio_mix *audio, const struct obs_source_audio_mix *child_audio, uint32_t mixers,
+		       size_t channels)
+{
+	for (size_t mix = 0; mix < MAX_AUDIO_MIXES; mix++) {
+		if ((mixers & (1 << mix)) == 0)
+			continue;
+
+		for (size_t ch = 0; ch < channels; ch++) {
+			float *out = audio->output[mix].data[ch];
+			const float *in = child_audio->output[mix].data[ch];
+			const float *end = in + AUDIO_OUTPUT_FRAMES;
+			while (in < end)
+				*(out++) += *(in++);
+		}
+	}
+}
+
 bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio, uint32_t mixers, size_t channels,
 			  size_t sample_rate)
 {
@@ -46,20 +65,11 @@ bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_
 		obs_source_release(source);
 		return true;
 	}
+	uint64_t start = os_gettime_ns();
 	struct obs_source_audio_mix child_audio;
 	obs_source_get_audio_mix(source, &child_audio);
-	for (size_t mix = 0; mix < MAX_AUDIO_MIXES; mix++) {
-		if ((mixers & (1 << mix)) == 0)
-			continue;
-
-		for (size_t ch = 0; ch < channels; ch++) {
-			float *out = audio->output[mix].data[ch];
-			float *in = child_audio.output[mix].data[ch];
-			float *end = in + AUDIO_OUTPUT_FRAMES;
-			while (in < end)
-				*(out++) += *(in++);
-		}
-	}
+	audio_wrapper_mix(audio, &child_audio, mixers, channels);
+	metrics_ring_push(aw->metrics, os_gettime_ns() - start);
 	*ts_out = timestamp;
 	obs_source_release(source);
 	return true;
@@ -3,13 +3,19 @@
 extern "C" {
 #endif
 
+struct metrics_ring;
+
 struct audio_wrapper_info {
 	obs_source_t *source;
 	void *param;
 	obs_source_t *(*target)(void *param);
 	uint32_t (*mixers)(void *param);
+	struct metrics_ring *metrics;
 };
 
+void audio_wrapper_mix(struct obs_source_audio_mix *audio, const struct obs_source_audio_mix *child_audio, uint32_t mixers,
+		       size_t channels);
+
 extern struct obs_source_info audio_wrapper_source;
 
 #ifdef __cplusplus
@@ -0,0 +1,115 @@
+#include "backtrack-saver.hpp"
+
+#include <algorithm>
+
+#include <obs.h>
+#include "util/platform.h"
+#include "util/threading.h"
+
+#define TS_PACKET_SIZE 188
+
+BacktrackSaver::BacktrackSaver()
+{
+	thread = std::thread([this] { Run(); });
+}
+
+BacktrackSaver::~BacktrackSaver()
+{
+	{
+		std::unique_lock<std::mutex> lock(jobsMutex);
+		stopping = true;
+	}
+	jobsCondition.notify_all();
+	if (thread.joinable())
+		thread.join();
+}
+
+bool BacktrackSaver::Busy() const
+{
+	return pending > 0;
+}
+
+void BacktrackSaver::SaveSegments(std::vector<std::string> files, std::string path, ProgressCallback progress, DoneCallback done)
+{
+	pending++;
+	{
+		std::unique_lock<std::mutex> lock(jobsMutex);
+		jobs.push_back({std::move(files), std::move(path), std::move(progress), std::move(done)});
+	}
+	jobsCondition.notify_one();
+}
+
+void BacktrackSaver::Run()
+{
+	os_set_thread_name("vertical-canvas: backtrack saver");
+	for (;;) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(jobsMutex);
+			jobsCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+			// finish queued saves before stopping, the clips were requested
+			if (jobs.empty())
+				return;
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		const bool success = WriteSegments(job);
+		if (success)
+			blog(LOG_INFO, "[Vertical Canvas] backtrack saved to %s", job.path.c_str());
+		pending--;
+		if (job.done)
+			job.done(success, job.path);
+	}
+}
+
+bool BacktrackSaver::WriteSegments(const Job &job)
+{
+	// the size is taken up front so a segment that is still growing does not stall the save
+	std::vector<int64_t> sizes;
+	int64_t total = 0;
+	for (const auto &file : job.files) {
+		int64_t size = os_get_file_size(file.c_str());
+		if (size < 0)
+			size = 0;
+		size -= size % TS_PACKET_SIZE;
+		sizes.push_back(size);
+		total += size;
+	}
+
+	FILE *out = os_fopen(job.path.c_str(), "wb");
+	if (!out) {
+		blog(LOG_WARNING, "[Vertical Canvas] backtrack saver failed to create %s", job.path.c_str());
+		return false;
+	}
+
+	bool success = true;
+	int64_t written = 0;
+	int last_percent = -1;
+	std::vector<uint8_t> buffer(TS_PACKET_SIZE * 1024);
+	for (size_t i = 0; success && i < job.files.size(); i++) {
+		int64_t remaining = sizes[i];
+		FILE *in = os_fopen(job.files[i].c_str(), "rb");
+		if (!in)
+			continue;
+		while (remaining > 0) {
+			size_t chunk = (size_t)std::min<int64_t>(remaining, (int64_t)buffer.size());
+			size_t read = fread(buffer.data(), 1, chunk, in);
+			if (!read)
+				break;
+			if (fwrite(buffer.data(), 1, read, out) != read) {
+				success = false;
+				break;
+			}
+			remaining -= (int64_t)read;
+			written += (int64_t)read;
+			const int percent = total ? (int)(written * 100 / total) : 100;
+			if (percent != last_percent && job.progress) {
+				last_percent = percent;
+				job.progress(percent);
+			}
+		}
+		fclose(in);
+	}
+	fclose(out);
+	return success;
+}
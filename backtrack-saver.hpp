@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Worker thread that writes saved backtracks to their final file.
+ * Jobs are handled in order, the encoded data is copied without re-encoding
+ * and progress is reported from the worker thread, callers marshal it to the
+ * UI themselves. */
+class BacktrackSaver {
+public:
+	typedef std::function<void(int percent)> ProgressCallback;
+	typedef std::function<void(bool success, std::string path)> DoneCallback;
+
+	BacktrackSaver();
+	~BacktrackSaver();
+
+	/* joins MPEG-TS segments into path, only whole packets are copied so the
+	 * segment that is still being written can be included */
+	void SaveSegments(std::vector<std::string> files, std::string path, ProgressCallback progress, DoneCallback done);
+	bool Busy() const;
+
+private:
+	struct Job {
+		std::vector<std::string> files;
+		std::string path;
+		ProgressCallback progress;
+		DoneCallback done;
+	};
+
+	std::thread thread;
+	std::mutex jobsMutex;
+	std::condition_variable jobsCondition;
+	std::deque<Job> jobs;
+	std::atomic<int> pending = 0;
+	bool stopping = false;
+
+	void Run();
+	bool WriteSegments(const Job &job);
+};
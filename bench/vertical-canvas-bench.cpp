@@ -0,0 +1,271 @@
+#include <obs.h>
+#include <util/platform.h>
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../audio-wrapper-source.h"
+#include "../canvas-geometry.hpp"
+#include "../multi-canvas-source.h"
+
+#define BENCH_WARMUP_ITERATIONS 3
+#define BENCH_MIN_DURATION_NS 200000000ULL
+#define BENCH_MAX_ITERATIONS 100000
+
+static const size_t bench_item_counts[] = {10, 100, 1000};
+
+/* Runs every case with synthetic inputs of 10, 100 and 1000 items and
+ * collects the timings as json. Cases only use plugin code that runs without
+ * a graphics device, an OBS core or a UI. */
+class Bench {
+public:
+	Bench(const char *filter) : filter(filter ? filter : "") { results = obs_data_array_create(); }
+	~Bench() { obs_data_array_release(results); }
+
+	void Run(const char *name, size_t items, const std::function<void()> &fn)
+	{
+		if (!filter.empty() && !strstr(name, filter.c_str()))
+			return;
+		for (int i = 0; i < BENCH_WARMUP_ITERATIONS; i++)
+			fn();
+
+		uint64_t total = 0;
+		uint64_t min = UINT64_MAX;
+		uint64_t iterations = 0;
+		while (total < BENCH_MIN_DURATION_NS && iterations < BENCH_MAX_ITERATIONS) {
+			const uint64_t start = os_gettime_ns();
+			fn();
+			const uint64_t elapsed = os_gettime_ns() - start;
+			total += elapsed;
+			if (elapsed < min)
+				min = elapsed;
+			iterations++;
+		}
+
+		obs_data_t *result = obs_data_create();
+		obs_data_set_string(result, "name", name);
+		obs_data_set_int(result, "items", (long long)items);
+		obs_data_set_int(result, "iterations", (long long)iterations);
+		obs_data_set_int(result, "min_ns", (long long)min);
+		obs_data_set_double(result, "mean_ns", (double)total / (double)iterations);
+		obs_data_set_double(result, "mean_ns_per_item", (double)total / (double)iterations / (double)items);
+		obs_data_array_push_back(results, result);
+		obs_data_release(result);
+		fprintf(stderr, "%-32s %6zu items %12.0f ns\n", name, items, (double)total / (double)iterations);
+	}
+
+	obs_data_array_t *Results() const { return results; }
+
+private:
+	std::string filter;
+	obs_data_array_t *results;
+};
+
+/* ------------------------------------------------------------------------- */
+
+struct audio_buffers {
+	std::vector<float> samples;
+	obs_source_audio_mix mix = {};
+
+	audio_buffers(size_t channels, float value) : samples(MAX_AUDIO_MIXES * channels * AUDIO_OUTPUT_FRAMES, value)
+	{
+		for (size_t m = 0; m < MAX_AUDIO_MIXES; m++) {
+			for (size_t ch = 0; ch < channels; ch++)
+				mix.output[m].data[ch] = samples.data() + (m * channels + ch) * AUDIO_OUTPUT_FRAMES;
+		}
+	}
+};
+
+static void bench_audio_mix(Bench &bench, const char *name, uint32_t mixers)
+{
+	const size_t channels = 2;
+	for (size_t items : bench_item_counts) {
+		audio_buffers out(channels, 0.0f);
+		std::vector<audio_buffers> children;
+		children.reserve(items);
+		for (size_t i = 0; i < items; i++)
+			children.emplace_back(channels, 1.0f / (float)(i + 1));
+		bench.Run(name, items, [&] {
+			for (const auto &child : children)
+				audio_wrapper_mix(&out.mix, &child.mix, mixers, channels);
+		});
+	}
+}
+
+static void bench_multi_canvas_layout(Bench &bench)
+{
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<uint32_t> size(240, 3840);
+	for (size_t items : bench_item_counts) {
+		std::vector<uint32_t> widths(items);
+		std::vector<uint32_t> heights(items);
+		for (size_t i = 0; i < items; i++) {
+			widths[i] = size(rng);
+			heights[i] = size(rng);
+		}
+		volatile uint32_t sink = 0;
+		bench.Run("multi_canvas_layout", items, [&] {
+			uint32_t width, height;
+			multi_canvas_layout(1920, 1080, widths.data(), heights.data(), items, &width, &height);
+			sink = width + height;
+		});
+		(void)sink;
+	}
+}
+
+static std::vector<matrix4> make_box_transforms(size_t items)
+{
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> pos(-200.0f, 2120.0f);
+	std::uniform_real_distribution<float> size(16.0f, 800.0f);
+	std::uniform_real_distribution<float> rot(0.0f, 360.0f);
+	std::vector<matrix4> transforms(items);
+	for (auto &transform : transforms) {
+		matrix4_identity(&transform);
+		matrix4_scale3f(&transform, &transform, size(rng), size(rng), 1.0f);
+		matrix4_rotate_aa4f(&transform, &transform, 0.0f, 0.0f, 1.0f, RAD(rot(rng)));
+		matrix4_translate3f(&transform, &transform, pos(rng), pos(rng), 0.0f);
+	}
+	return transforms;
+}
+
+static void bench_transformed_bounds(Bench &bench)
+{
+	for (size_t items : bench_item_counts) {
+		const std::vector<matrix4> transforms = make_box_transforms(items);
+		std::vector<vec2> tl(items), br(items);
+		bench.Run("transformed_bounds_scalar", items, [&] {
+			for (size_t i = 0; i < items; i++) {
+				vec3 tl3, br3;
+				GetTransformedBounds(transforms[i], tl3, br3);
+				vec2_set(&tl[i], tl3.x, tl3.y);
+				vec2_set(&br[i], br3.x, br3.y);
+			}
+		});
+		bench.Run("transformed_bounds_batched", items,
+			  [&] { GetTransformedBounds(transforms.data(), items, tl.data(), br.data()); });
+	}
+}
+
+static void bench_box_hit_test(Bench &bench)
+{
+	vec2 pos;
+	vec2_set(&pos, 960.0f, 540.0f);
+	for (size_t items : bench_item_counts) {
+		const std::vector<matrix4> transforms = make_box_transforms(items);
+		std::vector<uint8_t> hits(items);
+		volatile size_t sink = 0;
+		bench.Run("intersect_box", items, [&] {
+			size_t found = 0;
+			for (const auto &transform : transforms)
+				found += IntersectBox(transform, 400.0f, 1200.0f, 300.0f, 700.0f) ? 1 : 0;
+			sink = found;
+		});
+		bench.Run("box_hit_test_batched", items, [&] {
+			sink = BoxHitTest(transforms.data(), items, pos, 400.0f, 1200.0f, 300.0f, 700.0f, hits.data());
+		});
+		(void)sink;
+	}
+
+	// large enough to be split over the worker threads
+	const size_t items = BOX_HIT_TEST_PARALLEL_MIN * 4;
+	const std::vector<matrix4> transforms = make_box_transforms(items);
+	std::vector<uint8_t> hits(items);
+	volatile size_t sink = 0;
+	bench.Run("box_hit_test_parallel", items, [&] {
+		sink = BoxHitTest(transforms.data(), items, pos, 400.0f, 1200.0f, 300.0f, 700.0f, hits.data());
+	});
+	(void)sink;
+}
+
+static void bench_find_item_at_pos(Bench &bench)
+{
+	vec2 pos;
+	vec2_set(&pos, 960.0f, 540.0f);
+	for (size_t items : bench_item_counts) {
+		const std::vector<matrix4> transforms = make_box_transforms(items);
+		volatile size_t sink = 0;
+		// the topmost item wins, like FindItemAtPos walking the scene
+		bench.Run("find_item_at_pos", items, [&] {
+			size_t found = items;
+			for (size_t i = 0; i < items; i++) {
+				if (ItemContainsPos(transforms[i], pos))
+					found = i;
+			}
+			sink = found;
+		});
+		(void)sink;
+	}
+}
+
+static void bench_snap_item_movement(Bench &bench)
+{
+	vec2 screenSize;
+	vec2_set(&screenSize, 1080.0f, 1920.0f);
+	vec3 tl, br;
+	vec3_set(&tl, 500.0f, 700.0f, 0.0f);
+	vec3_set(&br, 900.0f, 1100.0f, 0.0f);
+	for (size_t items : bench_item_counts) {
+		const std::vector<matrix4> transforms = make_box_transforms(items);
+		volatile float sink = 0.0f;
+		// screen snapping first, then every other item like SnapItemMovement
+		bench.Run("snap_item_movement", items, [&] {
+			vec3 offset = GetScreenSnapOffset(tl, br, screenSize, 10.0f, true, true);
+			for (const auto &transform : transforms) {
+				vec3 itemTL, itemBR;
+				GetTransformedBounds(transform, itemTL, itemBR);
+				SnapToItemEdges(tl, br, itemTL, itemBR, 10.0f, offset);
+			}
+			sink = offset.x + offset.y;
+		});
+		(void)sink;
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+
+int main(int argc, char *argv[])
+{
+	const char *filter = nullptr;
+	const char *out = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			out = argv[++i];
+		} else {
+			fprintf(stderr, "usage: %s [--filter name] [--out results.json]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	int ret = 0;
+	{
+		Bench bench(filter);
+		bench_audio_mix(bench, "audio_mix_single_track", 1);
+		bench_audio_mix(bench, "audio_mix_all_tracks", (1 << MAX_AUDIO_MIXES) - 1);
+		bench_multi_canvas_layout(bench);
+		bench_transformed_bounds(bench);
+		bench_box_hit_test(bench);
+		bench_find_item_at_pos(bench);
+		bench_snap_item_movement(bench);
+
+		obs_data_t *report = obs_data_create();
+		obs_data_set_array(report, "results", bench.Results());
+		const char *json = obs_data_get_json(report);
+		if (out) {
+			if (!os_quick_write_utf8_file(out, json, strlen(json), false)) {
+				fprintf(stderr, "failed writing %s\n", out);
+				ret = 1;
+			}
+		} else {
+			printf("%s\n", json);
+		}
+		obs_data_release(report);
+	}
+	return ret;
+}
@@ -0,0 +1,379 @@
+#include "canvas-geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <obs.h>
+#include <util/sse-intrin.h>
+
+vec3 GetTransformedPos(float x, float y, const matrix4 &mat)
+{
+	vec3 result;
+	vec3_set(&result, x, y, 0.0f);
+	vec3_transform(&result, &result, &mat);
+	return result;
+}
+
+void RotatePos(vec2 *pos, float rot)
+{
+	float cosR = cos(rot);
+	float sinR = sin(rot);
+
+	vec2 newPos;
+
+	newPos.x = cosR * pos->x - sinR * pos->y;
+	newPos.y = sinR * pos->x + cosR * pos->y;
+
+	vec2_copy(pos, &newPos);
+}
+
+static bool CounterClockwise(float x1, float x2, float x3, float y1, float y2, float y3)
+{
+	return (y3 - y1) * (x2 - x1) > (y2 - y1) * (x3 - x1);
+}
+
+bool IntersectLine(float x1, float x2, float x3, float x4, float y1, float y2, float y3, float y4)
+{
+	bool a = CounterClockwise(x1, x2, x3, y1, y2, y3);
+	bool b = CounterClockwise(x1, x2, x4, y1, y2, y4);
+	bool c = CounterClockwise(x3, x4, x1, y3, y4, y1);
+	bool d = CounterClockwise(x3, x4, x2, y3, y4, y2);
+
+	return (a != b) && (c != d);
+}
+
+static bool IntersectEdge(float x1, float x2, float y1, float y2, float x3, float y3, float x4, float y4)
+{
+	return IntersectLine(x1, x1, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y1, y1, y3, y4) ||
+	       IntersectLine(x2, x2, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y2, y2, y3, y4);
+}
+
+bool IntersectBox(const matrix4 &transform, float x1, float x2, float y1, float y2)
+{
+	const float tx = transform.t.x;
+	const float ty = transform.t.y;
+
+	return IntersectEdge(x1, x2, y1, y2, tx, ty, tx + transform.x.x, ty + transform.x.y) ||
+	       IntersectEdge(x1, x2, y1, y2, tx, ty, tx + transform.y.x, ty + transform.y.y) ||
+	       IntersectEdge(x1, x2, y1, y2, tx + transform.x.x, ty + transform.x.y, tx + transform.x.x + transform.y.x,
+			     ty + transform.x.y + transform.y.y) ||
+	       IntersectEdge(x1, x2, y1, y2, tx + transform.y.x, ty + transform.y.y, tx + transform.y.x + transform.x.x,
+			     ty + transform.y.y + transform.x.y);
+}
+
+void ClampAspect(vec3 &tl, vec3 &br, vec2 &size, const vec2 &baseSize, uint32_t handle)
+{
+	float baseAspect = baseSize.x / baseSize.y;
+	float aspect = size.x / size.y;
+	const bool horizontal = (handle & (ITEM_LEFT | ITEM_RIGHT)) != 0;
+	const bool vertical = (handle & (ITEM_TOP | ITEM_BOTTOM)) != 0;
+
+	if (horizontal && vertical) {
+		if (aspect < baseAspect) {
+			if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
+				size.x = size.y * baseAspect;
+			else
+				size.x = size.y * baseAspect * -1.0f;
+		} else {
+			if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
+				size.y = size.x / baseAspect;
+			else
+				size.y = size.x / baseAspect * -1.0f;
+		}
+
+	} else if (vertical) {
+		if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
+			size.x = size.y * baseAspect;
+		else
+			size.x = size.y * baseAspect * -1.0f;
+
+	} else if (horizontal) {
+		if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
+			size.y = size.x / baseAspect;
+		else
+			size.y = size.x / baseAspect * -1.0f;
+	}
+
+	size.x = std::round(size.x);
+	size.y = std::round(size.y);
+
+	if (handle & ITEM_LEFT)
+		tl.x = br.x - size.x;
+	else if (handle & ITEM_RIGHT)
+		br.x = tl.x + size.x;
+
+	if (handle & ITEM_TOP)
+		tl.y = br.y - size.y;
+	else if (handle & ITEM_BOTTOM)
+		br.y = tl.y + size.y;
+}
+
+vec3 CalculateStretchPos(const vec3 &tl, const vec3 &br, uint32_t alignment)
+{
+	vec3 pos;
+
+	vec3_zero(&pos);
+
+	if (alignment & OBS_ALIGN_LEFT)
+		pos.x = tl.x;
+	else if (alignment & OBS_ALIGN_RIGHT)
+		pos.x = br.x;
+	else
+		pos.x = (br.x - tl.x) * 0.5f + tl.x;
+
+	if (alignment & OBS_ALIGN_TOP)
+		pos.y = tl.y;
+	else if (alignment & OBS_ALIGN_BOTTOM)
+		pos.y = br.y;
+	else
+		pos.y = (br.y - tl.y) * 0.5f + tl.y;
+
+	return pos;
+}
+
+static bool CloseFloat(float a, float b, float epsilon = 0.01f)
+{
+	return std::abs(a - b) <= epsilon;
+}
+
+bool ItemContainsPos(const matrix4 &transform, const vec2 &pos)
+{
+	matrix4 invTransform;
+	vec3 transformedPos;
+	vec3 pos3;
+	vec3 pos3_;
+
+	vec3_set(&pos3, pos.x, pos.y, 0.0f);
+
+	// a zero sized item has no inverse and contains nothing
+	if (!matrix4_inv(&invTransform, &transform))
+		return false;
+	vec3_transform(&transformedPos, &pos3, &invTransform);
+	vec3_transform(&pos3_, &transformedPos, &transform);
+
+	return CloseFloat(pos3.x, pos3_.x) && CloseFloat(pos3.y, pos3_.y) && transformedPos.x >= 0.0f && transformedPos.x <= 1.0f &&
+	       transformedPos.y >= 0.0f && transformedPos.y <= 1.0f;
+}
+
+vec3 GetScreenSnapOffset(const vec3 &tl, const vec3 &br, const vec2 &screenSize, float clampDist, bool screenSnap, bool centerSnap)
+{
+	vec3 clampOffset;
+
+	vec3_zero(&clampOffset);
+
+	const float centerX = br.x - (br.x - tl.x) / 2.0f;
+	const float centerY = br.y - (br.y - tl.y) / 2.0f;
+
+	// Left screen edge.
+	if (screenSnap && fabsf(tl.x) < clampDist)
+		clampOffset.x = -tl.x;
+	// Right screen edge.
+	if (screenSnap && fabsf(clampOffset.x) < EPSILON && fabsf(screenSize.x - br.x) < clampDist)
+		clampOffset.x = screenSize.x - br.x;
+	// Horizontal center.
+	if (centerSnap && fabsf(screenSize.x - (br.x - tl.x)) > clampDist && fabsf(screenSize.x / 2.0f - centerX) < clampDist)
+		clampOffset.x = screenSize.x / 2.0f - centerX;
+
+	// Top screen edge.
+	if (screenSnap && fabsf(tl.y) < clampDist)
+		clampOffset.y = -tl.y;
+	// Bottom screen edge.
+	if (screenSnap && fabsf(clampOffset.y) < EPSILON && fabsf(screenSize.y - br.y) < clampDist)
+		clampOffset.y = screenSize.y - br.y;
+	// Vertical center.
+	if (centerSnap && fabsf(screenSize.y - (br.y - tl.y)) > clampDist && fabsf(screenSize.y / 2.0f - centerY) < clampDist)
+		clampOffset.y = screenSize.y / 2.0f - centerY;
+
+	return clampOffset;
+}
+
+void SnapToItemEdges(const vec3 &tl, const vec3 &br, const vec3 &itemTL, const vec3 &itemBR, float clampDist, vec3 &offset)
+{
+#define EDGE_SNAP(l, r, x, y)                                                                                          \
+	do {                                                                                                           \
+		double dist = fabsf(item##l.x - r.x);                                                                  \
+		if (dist < clampDist && fabsf(offset.x) < EPSILON && tl.y < itemBR.y && br.y > itemTL.y &&             \
+		    (fabsf(offset.x) > dist || offset.x < EPSILON))                                                    \
+			offset.x = item##l.x - r.x;                                                                    \
+	} while (false)
+
+	EDGE_SNAP(TL, br, x, y);
+	EDGE_SNAP(TL, br, y, x);
+	EDGE_SNAP(BR, tl, x, y);
+	EDGE_SNAP(BR, tl, y, x);
+#undef EDGE_SNAP
+}
+
+void GetTransformedBounds(const matrix4 &transform, vec3 &tl, vec3 &br)
+{
+	vec3_set(&tl, M_INFINITE, M_INFINITE, 0.0f);
+	vec3_set(&br, -M_INFINITE, -M_INFINITE, 0.0f);
+
+	auto GetMinPos = [&](float x, float y) {
+		vec3 pos = GetTransformedPos(x, y, transform);
+		vec3_min(&tl, &tl, &pos);
+		vec3_max(&br, &br, &pos);
+	};
+
+	GetMinPos(0.0f, 0.0f);
+	GetMinPos(1.0f, 0.0f);
+	GetMinPos(0.0f, 1.0f);
+	GetMinPos(1.0f, 1.0f);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/* the 2d part of up to four box transforms, one per lane */
+struct transform_lanes {
+	__m128 tx, ty;
+	__m128 xx, xy;
+	__m128 yx, yy;
+};
+
+static inline transform_lanes load_lanes(const matrix4 *m, size_t count)
+{
+	float v[6][4] = {};
+	for (size_t i = 0; i < count; i++) {
+		v[0][i] = m[i].t.x;
+		v[1][i] = m[i].t.y;
+		v[2][i] = m[i].x.x;
+		v[3][i] = m[i].x.y;
+		v[4][i] = m[i].y.x;
+		v[5][i] = m[i].y.y;
+	}
+	transform_lanes l;
+	l.tx = _mm_loadu_ps(v[0]);
+	l.ty = _mm_loadu_ps(v[1]);
+	l.xx = _mm_loadu_ps(v[2]);
+	l.xy = _mm_loadu_ps(v[3]);
+	l.yx = _mm_loadu_ps(v[4]);
+	l.yy = _mm_loadu_ps(v[5]);
+	return l;
+}
+
+void GetTransformedBounds(const matrix4 *transforms, size_t count, vec2 *tl, vec2 *br)
+{
+	for (size_t i = 0; i < count; i += 4) {
+		const size_t n = count - i < 4 ? count - i : 4;
+		const transform_lanes l = load_lanes(transforms + i, n);
+
+		const __m128 x1 = _mm_add_ps(l.tx, l.xx);
+		const __m128 y1 = _mm_add_ps(l.ty, l.xy);
+		const __m128 x2 = _mm_add_ps(l.tx, l.yx);
+		const __m128 y2 = _mm_add_ps(l.ty, l.yy);
+		const __m128 x3 = _mm_add_ps(x1, l.yx);
+		const __m128 y3 = _mm_add_ps(y1, l.yy);
+
+		float min_x[4], min_y[4], max_x[4], max_y[4];
+		_mm_storeu_ps(min_x, _mm_min_ps(_mm_min_ps(l.tx, x1), _mm_min_ps(x2, x3)));
+		_mm_storeu_ps(min_y, _mm_min_ps(_mm_min_ps(l.ty, y1), _mm_min_ps(y2, y3)));
+		_mm_storeu_ps(max_x, _mm_max_ps(_mm_max_ps(l.tx, x1), _mm_max_ps(x2, x3)));
+		_mm_storeu_ps(max_y, _mm_max_ps(_mm_max_ps(l.ty, y1), _mm_max_ps(y2, y3)));
+		for (size_t j = 0; j < n; j++) {
+			vec2_set(&tl[i + j], min_x[j], min_y[j]);
+			vec2_set(&br[i + j], max_x[j], max_y[j]);
+		}
+	}
+}
+
+static size_t BoxHitTestRange(const matrix4 *transforms, size_t count, const vec2 &pos, float x1, float x2, float y1, float y2,
+			      uint8_t *hits)
+{
+	const __m128 bx1 = _mm_set1_ps(x1);
+	const __m128 bx2 = _mm_set1_ps(x2);
+	const __m128 by1 = _mm_set1_ps(y1);
+	const __m128 by2 = _mm_set1_ps(y2);
+	const __m128 px = _mm_set1_ps(pos.x);
+	const __m128 py = _mm_set1_ps(pos.y);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	auto inside = [&](__m128 x, __m128 y) {
+		return _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(x, bx1), _mm_cmplt_ps(x, bx2)),
+				  _mm_and_ps(_mm_cmpgt_ps(y, by1), _mm_cmplt_ps(y, by2)));
+	};
+
+	size_t found = 0;
+	for (size_t i = 0; i < count; i += 4) {
+		const size_t n = count - i < 4 ? count - i : 4;
+		const transform_lanes l = load_lanes(transforms + i, n);
+
+		const __m128 cx1 = _mm_add_ps(l.tx, l.xx);
+		const __m128 cy1 = _mm_add_ps(l.ty, l.xy);
+		const __m128 cx2 = _mm_add_ps(l.tx, l.yx);
+		const __m128 cy2 = _mm_add_ps(l.ty, l.yy);
+		const __m128 cx3 = _mm_add_ps(cx1, l.yx);
+		const __m128 cy3 = _mm_add_ps(cy1, l.yy);
+
+		// a corner or the center inside the box
+		__m128 hit = inside(l.tx, l.ty);
+		hit = _mm_or_ps(hit, inside(cx1, cy1));
+		hit = _mm_or_ps(hit, inside(cx2, cy2));
+		hit = _mm_or_ps(hit, inside(cx3, cy3));
+		hit = _mm_or_ps(hit, inside(_mm_add_ps(l.tx, _mm_mul_ps(half, _mm_add_ps(l.xx, l.yx))),
+					    _mm_add_ps(l.ty, _mm_mul_ps(half, _mm_add_ps(l.xy, l.yy)))));
+
+		// pos inside the item, pos mapped back into the unit square
+		const __m128 dx = _mm_sub_ps(px, l.tx);
+		const __m128 dy = _mm_sub_ps(py, l.ty);
+		const __m128 det = _mm_sub_ps(_mm_mul_ps(l.xx, l.yy), _mm_mul_ps(l.yx, l.xy));
+		const __m128 u = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(dx, l.yy), _mm_mul_ps(dy, l.yx)), det);
+		const __m128 v = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(dy, l.xx), _mm_mul_ps(dx, l.xy)), det);
+		__m128 contains = _mm_cmpneq_ps(det, zero);
+		contains = _mm_and_ps(contains, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+		contains = _mm_and_ps(contains, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(v, one)));
+		hit = _mm_or_ps(hit, contains);
+
+		// an edge can only cross the box when the item bounds overlap it
+		const __m128 min_x = _mm_min_ps(_mm_min_ps(l.tx, cx1), _mm_min_ps(cx2, cx3));
+		const __m128 min_y = _mm_min_ps(_mm_min_ps(l.ty, cy1), _mm_min_ps(cy2, cy3));
+		const __m128 max_x = _mm_max_ps(_mm_max_ps(l.tx, cx1), _mm_max_ps(cx2, cx3));
+		const __m128 max_y = _mm_max_ps(_mm_max_ps(l.ty, cy1), _mm_max_ps(cy2, cy3));
+		const __m128 overlap = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(max_x, bx1), _mm_cmple_ps(min_x, bx2)),
+						  _mm_and_ps(_mm_cmpge_ps(max_y, by1), _mm_cmple_ps(min_y, by2)));
+
+		const int mask = _mm_movemask_ps(hit);
+		const int edge_mask = _mm_movemask_ps(_mm_andnot_ps(hit, overlap));
+		for (size_t j = 0; j < n; j++) {
+			// only items that overlap the box without a corner inside go through the scalar edge test
+			const bool h = (mask & (1 << j)) || ((edge_mask & (1 << j)) && IntersectBox(transforms[i + j], x1, x2, y1, y2));
+			hits[i + j] = h ? 1 : 0;
+			if (h)
+				found++;
+		}
+	}
+	return found;
+}
+
+size_t BoxHitTest(const matrix4 *transforms, size_t count, const vec2 &pos, float x1, float x2, float y1, float y2, uint8_t *hits)
+{
+	size_t workers = std::min<size_t>(std::thread::hardware_concurrency(), BOX_HIT_TEST_MAX_WORKERS);
+	if (count < BOX_HIT_TEST_PARALLEL_MIN || workers < 2)
+		return BoxHitTestRange(transforms, count, pos, x1, x2, y1, y2, hits);
+
+	// chunks stay a multiple of four so only the last one has a partial register
+	const size_t chunk = ((count + workers - 1) / workers + 3) & ~(size_t)3;
+	workers = (count + chunk - 1) / chunk;
+
+	std::vector<size_t> found(workers, 0);
+	std::vector<std::thread> threads;
+	threads.reserve(workers - 1);
+	for (size_t w = 1; w < workers; w++) {
+		const size_t begin = w * chunk;
+		const size_t n = std::min(chunk, count - begin);
+		threads.emplace_back([=, &found, &pos] {
+			found[w] = BoxHitTestRange(transforms + begin, n, pos, x1, x2, y1, y2, hits + begin);
+		});
+	}
+	found[0] = BoxHitTestRange(transforms, chunk, pos, x1, x2, y1, y2, hits);
+	for (auto &thread : threads)
+		thread.join();
+
+	size_t total = 0;
+	for (size_t f : found)
+		total += f;
+	return total;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <graphics/matrix4.h>
+#include <graphics/vec2.h>
+#include <graphics/vec3.h>
+
+#define ITEM_LEFT (1 << 0)
+#define ITEM_RIGHT (1 << 1)
+#define ITEM_TOP (1 << 2)
+#define ITEM_BOTTOM (1 << 3)
+#define ITEM_ROT (1 << 4)
+
+#define BOX_HIT_TEST_PARALLEL_MIN 4096
+#define BOX_HIT_TEST_MAX_WORKERS 4
+
+/* Transform and hit-test math for the canvas preview.
+ * Item transforms are box transforms that map the unit square onto the
+ * canvas. The batched functions take flat arrays of them and process four
+ * items per SSE register, libobs maps the intrinsics to NEON on arm. */
+
+vec3 GetTransformedPos(float x, float y, const matrix4 &mat);
+void RotatePos(vec2 *pos, float rot);
+
+bool IntersectLine(float x1, float x2, float x3, float x4, float y1, float y2, float y3, float y4);
+bool IntersectBox(const matrix4 &transform, float x1, float x2, float y1, float y2);
+
+/* handle is a combination of the ITEM_ side flags of the dragged handle */
+void ClampAspect(vec3 &tl, vec3 &br, vec2 &size, const vec2 &baseSize, uint32_t handle);
+vec3 CalculateStretchPos(const vec3 &tl, const vec3 &br, uint32_t alignment);
+
+/* pos inside the transformed unit square, the click test of the preview */
+bool ItemContainsPos(const matrix4 &transform, const vec2 &pos);
+
+/* offset that snaps the bounds tl..br to the screen edges and center when
+ * they are within clampDist of them */
+vec3 GetScreenSnapOffset(const vec3 &tl, const vec3 &br, const vec2 &screenSize, float clampDist, bool screenSnap, bool centerSnap);
+/* snaps the bounds tl..br to the edges of another item with the bounds
+ * itemTL..itemBR, offset holds the snap found so far and is updated */
+void SnapToItemEdges(const vec3 &tl, const vec3 &br, const vec3 &itemTL, const vec3 &itemBR, float clampDist, vec3 &offset);
+
+/* axis aligned bounds of the transformed unit square */
+void GetTransformedBounds(const matrix4 &transform, vec3 &tl, vec3 &br);
+void GetTransformedBounds(const matrix4 *transforms, size_t count, vec2 *tl, vec2 *br);
+
+/* rubber band selection: hits[i] is set when the transformed unit square
+ * contains pos, has a corner or its center inside the box x1..x2, y1..y2 or
+ * has an edge crossing the box, returns the number of hits.
+ * Corners, center, pos and the bounds overlap are tested four items at a
+ * time, only items whose bounds overlap the box without a corner inside run
+ * the scalar edge test.
+ * From BOX_HIT_TEST_PARALLEL_MIN items on the array is split over up to
+ * BOX_HIT_TEST_MAX_WORKERS threads, the transforms must not change meanwhile. */
+size_t BoxHitTest(const matrix4 *transforms, size_t count, const vec2 &pos, float x1, float x2, float y1, float y2, uint8_t *hits);
@@ -0,0 +1,114 @@
+#include "canvas-metrics.hpp"
+
+#include <algorithm>
+
+#define METRICS_HISTORY_SIZE 4096
+
+CanvasMetrics::CanvasMetrics()
+{
+	auto init = [this](CanvasMetric metric, const char *name, const char *unit, double scale) {
+		auto &s = series[(size_t)metric];
+		s.name = name;
+		s.unit = unit;
+		s.scale = scale;
+		s.history.reserve(METRICS_HISTORY_SIZE);
+	};
+	init(CanvasMetric::DrawPreview, "draw_preview", "ms", 1.0 / 1000000.0);
+	init(CanvasMetric::MultiCanvasRender, "multi_canvas_render", "ms", 1.0 / 1000000.0);
+	init(CanvasMetric::AudioWrapperRender, "audio_wrapper_render", "ms", 1.0 / 1000000.0);
+	init(CanvasMetric::CanvasRender, "canvas_render", "ms", 1.0 / 1000000.0);
+	init(CanvasMetric::OutputFrames, "output_frames", "frames", 1.0);
+	init(CanvasMetric::SkippedFrames, "skipped_frames", "frames", 1.0);
+}
+
+void CanvasMetrics::Collect()
+{
+	std::unique_lock<std::mutex> lock(historyMutex);
+	for (auto &s : series) {
+		uint64_t value;
+		while (metrics_ring_pop(&s.ring, &value)) {
+			if (s.history.size() < METRICS_HISTORY_SIZE) {
+				s.history.push_back(value);
+			} else {
+				s.history[s.next] = value;
+			}
+			s.next = (s.next + 1) % METRICS_HISTORY_SIZE;
+			s.total++;
+		}
+	}
+}
+
+void CanvasMetrics::Reset()
+{
+	std::unique_lock<std::mutex> lock(historyMutex);
+	for (auto &s : series) {
+		s.history.clear();
+		s.next = 0;
+		s.total = 0;
+		os_atomic_set_long(&s.ring.dropped, 0);
+	}
+}
+
+CanvasMetrics::Summary CanvasMetrics::Summarize(const Series &s)
+{
+	Summary summary;
+	summary.dropped = os_atomic_load_long(&s.ring.dropped);
+	summary.samples = s.history.size();
+	if (s.history.empty())
+		return summary;
+
+	std::vector<uint64_t> sorted = s.history;
+	std::sort(sorted.begin(), sorted.end());
+	auto percentile = [&sorted, &s](double p) {
+		size_t idx = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+		return (double)sorted[idx] * s.scale;
+	};
+	summary.p50 = percentile(0.50);
+	summary.p90 = percentile(0.90);
+	summary.p99 = percentile(0.99);
+	summary.max = (double)sorted.back() * s.scale;
+	double sum = 0.0;
+	for (auto v : sorted)
+		sum += (double)v;
+	summary.avg = sum / (double)sorted.size() * s.scale;
+	return summary;
+}
+
+void CanvasMetrics::ToJson(obs_data_t *data)
+{
+	std::unique_lock<std::mutex> lock(historyMutex);
+	auto metrics = obs_data_array_create();
+	for (const auto &s : series) {
+		auto summary = Summarize(s);
+		auto m = obs_data_create();
+		obs_data_set_string(m, "name", s.name);
+		obs_data_set_string(m, "unit", s.unit);
+		obs_data_set_int(m, "samples", (long long)summary.samples);
+		obs_data_set_int(m, "total_samples", (long long)s.total);
+		obs_data_set_int(m, "dropped_samples", summary.dropped);
+		obs_data_set_double(m, "p50", summary.p50);
+		obs_data_set_double(m, "p90", summary.p90);
+		obs_data_set_double(m, "p99", summary.p99);
+		obs_data_set_double(m, "max", summary.max);
+		obs_data_set_double(m, "avg", summary.avg);
+		obs_data_array_push_back(metrics, m);
+		obs_data_release(m);
+	}
+	obs_data_set_array(data, "metrics", metrics);
+	obs_data_array_release(metrics);
+}
+
+std::string CanvasMetrics::ToCsv()
+{
+	std::unique_lock<std::mutex> lock(historyMutex);
+	std::string csv = "name,unit,samples,total_samples,dropped_samples,p50,p90,p99,max,avg\n";
+	char line[512];
+	for (const auto &s : series) {
+		auto summary = Summarize(s);
+		snprintf(line, sizeof(line), "%s,%s,%zu,%llu,%ld,%.4f,%.4f,%.4f,%.4f,%.4f\n", s.name, s.unit, summary.samples,
+			 (unsigned long long)s.total, summary.dropped, summary.p50, summary.p90, summary.p99, summary.max,
+			 summary.avg);
+		csv += line;
+	}
+	return csv;
+}
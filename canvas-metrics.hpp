@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <obs.h>
+
+#include "metrics-ring.h"
+
+enum class CanvasMetric : size_t {
+	DrawPreview,
+	MultiCanvasRender,
+	AudioWrapperRender,
+	CanvasRender,
+	OutputFrames,
+	SkippedFrames,
+	Count,
+};
+
+class CanvasMetrics {
+public:
+	CanvasMetrics();
+
+	inline struct metrics_ring *GetRing(CanvasMetric metric) { return &series[(size_t)metric].ring; }
+
+	void Collect();
+	void Reset();
+	void ToJson(obs_data_t *data);
+	std::string ToCsv();
+
+private:
+	struct Series {
+		const char *name = nullptr;
+		const char *unit = nullptr;
+		double scale = 1.0;
+		struct metrics_ring ring = {};
+		std::vector<uint64_t> history;
+		size_t next = 0;
+		uint64_t total = 0;
+	};
+
+	struct Summary {
+		size_t samples = 0;
+		double p50 = 0.0;
+		double p90 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double avg = 0.0;
+		long dropped = 0;
+	};
+
+	Series series[(size_t)CanvasMetric::Count];
+	std::mutex historyMutex;
+
+	Summary Summarize(const Series &s);
+};
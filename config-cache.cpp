@@ -0,0 +1,392 @@
+#include "config-cache.hpp"
+
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+
+#include "util/platform.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define CONFIG_CACHE_MAGIC 0x42434356 // "VCCB"
+#define CONFIG_CACHE_VERSION 2
+
+enum cache_item_type : uint8_t {
+	CACHE_NULL,
+	CACHE_STRING,
+	CACHE_INT,
+	CACHE_DOUBLE,
+	CACHE_BOOL,
+	CACHE_OBJECT,
+	CACHE_ARRAY,
+};
+
+struct cache_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t json_size;
+	uint64_t json_hash;
+	uint64_t payload_size;
+	uint64_t checksum;
+};
+
+static uint64_t fnv1a(const uint8_t *data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+
+class MappedFile {
+public:
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+
+	MappedFile(const char *path)
+	{
+#ifdef _WIN32
+		wchar_t *wpath = nullptr;
+		os_utf8_to_wcs_ptr(path, 0, &wpath);
+		if (!wpath)
+			return;
+		file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		bfree(wpath);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || !file_size.QuadPart)
+			return;
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+			return;
+		data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data)
+			size = (size_t)file_size.QuadPart;
+#else
+		fd = open(path, O_RDONLY);
+		if (fd < 0)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || !st.st_size)
+			return;
+		void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+			return;
+		data = (const uint8_t *)p;
+		size = (size_t)st.st_size;
+#endif
+	}
+
+	~MappedFile()
+	{
+#ifdef _WIN32
+		if (data)
+			UnmapViewOfFile(data);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+#else
+		if (data)
+			munmap((void *)data, size);
+		if (fd >= 0)
+			close(fd);
+#endif
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+};
+
+/* ------------------------------------------------------------------------- */
+
+/* hashes the JSON content, a copy or a restored backup with a new
+ * modification time still matches and an edit keeping the size does not */
+static bool json_hash(const char *json_path, uint64_t &size, uint64_t &hash)
+{
+	MappedFile json(json_path);
+	if (!json.data)
+		return false;
+	size = json.size;
+	hash = fnv1a(json.data, json.size);
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void write_u32(std::string &out, uint32_t v)
+{
+	out.append((const char *)&v, sizeof(v));
+}
+
+static void write_string(std::string &out, const char *s)
+{
+	const uint32_t len = s ? (uint32_t)strlen(s) : 0;
+	write_u32(out, len);
+	out.append(s ? s : "", len);
+}
+
+static void encode_array(std::string &out, obs_data_array_t *array);
+
+static void encode_object(std::string &out, obs_data_t *data)
+{
+	const size_t count_pos = out.size();
+	uint32_t count = 0;
+	write_u32(out, 0);
+	for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item)) {
+		write_string(out, obs_data_item_get_name(item));
+		switch (obs_data_item_gettype(item)) {
+		case OBS_DATA_STRING:
+			out.push_back((char)CACHE_STRING);
+			write_string(out, obs_data_item_get_string(item));
+			break;
+		case OBS_DATA_NUMBER:
+			if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE) {
+				out.push_back((char)CACHE_DOUBLE);
+				const double d = obs_data_item_get_double(item);
+				out.append((const char *)&d, sizeof(d));
+			} else {
+				out.push_back((char)CACHE_INT);
+				const long long i = obs_data_item_get_int(item);
+				out.append((const char *)&i, sizeof(i));
+			}
+			break;
+		case OBS_DATA_BOOLEAN:
+			out.push_back((char)CACHE_BOOL);
+			out.push_back(obs_data_item_get_bool(item) ? 1 : 0);
+			break;
+		case OBS_DATA_OBJECT: {
+			obs_data_t *obj = obs_data_item_get_obj(item);
+			if (obj) {
+				out.push_back((char)CACHE_OBJECT);
+				encode_object(out, obj);
+				obs_data_release(obj);
+			} else {
+				out.push_back((char)CACHE_NULL);
+			}
+			break;
+		}
+		case OBS_DATA_ARRAY: {
+			obs_data_array_t *array = obs_data_item_get_array(item);
+			if (array) {
+				out.push_back((char)CACHE_ARRAY);
+				encode_array(out, array);
+				obs_data_array_release(array);
+			} else {
+				out.push_back((char)CACHE_NULL);
+			}
+			break;
+		}
+		default:
+			out.push_back((char)CACHE_NULL);
+			break;
+		}
+		count++;
+	}
+	memcpy(&out[count_pos], &count, sizeof(count));
+}
+
+static void encode_array(std::string &out, obs_data_array_t *array)
+{
+	const size_t count = obs_data_array_count(array);
+	write_u32(out, (uint32_t)count);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(array, i);
+		encode_object(out, item);
+		obs_data_release(item);
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+
+struct cache_reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+	bool failed;
+};
+
+static bool read_bytes(cache_reader &r, void *dst, size_t size)
+{
+	if (r.failed || (size_t)(r.end - r.pos) < size) {
+		r.failed = true;
+		return false;
+	}
+	memcpy(dst, r.pos, size);
+	r.pos += size;
+	return true;
+}
+
+static uint32_t read_u32(cache_reader &r)
+{
+	uint32_t v = 0;
+	read_bytes(r, &v, sizeof(v));
+	return v;
+}
+
+static std::string read_string(cache_reader &r)
+{
+	const uint32_t len = read_u32(r);
+	if (r.failed || (size_t)(r.end - r.pos) < len) {
+		r.failed = true;
+		return std::string();
+	}
+	std::string s((const char *)r.pos, len);
+	r.pos += len;
+	return s;
+}
+
+static obs_data_array_t *decode_array(cache_reader &r, int depth);
+
+static obs_data_t *decode_object(cache_reader &r, int depth)
+{
+	obs_data_t *data = obs_data_create();
+	if (depth > 64) {
+		r.failed = true;
+		return data;
+	}
+	const uint32_t count = read_u32(r);
+	for (uint32_t i = 0; i < count && !r.failed; i++) {
+		const std::string name = read_string(r);
+		uint8_t type = CACHE_NULL;
+		read_bytes(r, &type, sizeof(type));
+		if (r.failed)
+			break;
+		switch (type) {
+		case CACHE_STRING:
+			obs_data_set_string(data, name.c_str(), read_string(r).c_str());
+			break;
+		case CACHE_INT: {
+			long long v = 0;
+			if (read_bytes(r, &v, sizeof(v)))
+				obs_data_set_int(data, name.c_str(), v);
+			break;
+		}
+		case CACHE_DOUBLE: {
+			double v = 0.0;
+			if (read_bytes(r, &v, sizeof(v)))
+				obs_data_set_double(data, name.c_str(), v);
+			break;
+		}
+		case CACHE_BOOL: {
+			uint8_t v = 0;
+			if (read_bytes(r, &v, sizeof(v)))
+				obs_data_set_bool(data, name.c_str(), v != 0);
+			break;
+		}
+		case CACHE_OBJECT: {
+			obs_data_t *obj = decode_object(r, depth + 1);
+			obs_data_set_obj(data, name.c_str(), obj);
+			obs_data_release(obj);
+			break;
+		}
+		case CACHE_ARRAY: {
+			obs_data_array_t *array = decode_array(r, depth + 1);
+			obs_data_set_array(data, name.c_str(), array);
+			obs_data_array_release(array);
+			break;
+		}
+		case CACHE_NULL:
+			break;
+		default:
+			r.failed = true;
+			break;
+		}
+	}
+	return data;
+}
+
+static obs_data_array_t *decode_array(cache_reader &r, int depth)
+{
+	obs_data_array_t *array = obs_data_array_create();
+	const uint32_t count = read_u32(r);
+	for (uint32_t i = 0; i < count && !r.failed; i++) {
+		obs_data_t *item = decode_object(r, depth + 1);
+		obs_data_array_push_back(array, item);
+		obs_data_release(item);
+	}
+	return array;
+}
+
+/* ------------------------------------------------------------------------- */
+
+obs_data_t *ConfigCache::Load(const char *json_path, const char *cache_path)
+{
+	uint64_t json_size;
+	uint64_t json_content_hash;
+	if (!json_hash(json_path, json_size, json_content_hash))
+		return nullptr;
+
+	MappedFile file(cache_path);
+	if (!file.data || file.size < sizeof(cache_header))
+		return nullptr;
+
+	cache_header header;
+	memcpy(&header, file.data, sizeof(header));
+	if (header.magic != CONFIG_CACHE_MAGIC || header.version != CONFIG_CACHE_VERSION)
+		return nullptr;
+	if (header.json_size != json_size || header.json_hash != json_content_hash) {
+		blog(LOG_INFO, "[Vertical Canvas] config cache does not match the configuration file");
+		return nullptr;
+	}
+	if (header.payload_size != file.size - sizeof(header))
+		return nullptr;
+	const uint8_t *payload = file.data + sizeof(header);
+	if (fnv1a(payload, (size_t)header.payload_size) != header.checksum) {
+		blog(LOG_WARNING, "[Vertical Canvas] config cache checksum mismatch");
+		return nullptr;
+	}
+
+	cache_reader r = {payload, payload + header.payload_size, false};
+	obs_data_t *config = decode_object(r, 0);
+	if (r.failed || r.pos != r.end) {
+		blog(LOG_WARNING, "[Vertical Canvas] config cache is corrupt");
+		obs_data_release(config);
+		return nullptr;
+	}
+	return config;
+}
+
+bool ConfigCache::Save(obs_data_t *config, const char *json_path, const char *cache_path)
+{
+	cache_header header = {};
+	if (!json_hash(json_path, header.json_size, header.json_hash))
+		return false;
+
+	std::string payload;
+	encode_object(payload, config);
+	header.magic = CONFIG_CACHE_MAGIC;
+	header.version = CONFIG_CACHE_VERSION;
+	header.payload_size = payload.size();
+	header.checksum = fnv1a((const uint8_t *)payload.data(), payload.size());
+
+	std::string tmp = cache_path;
+	tmp += ".tmp";
+	FILE *f = os_fopen(tmp.c_str(), "wb");
+	if (!f)
+		return false;
+	bool success = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		       (payload.empty() || fwrite(payload.data(), payload.size(), 1, f) == 1);
+	fclose(f);
+	if (success)
+		success = os_safe_replace(cache_path, tmp.c_str(), nullptr) == 0;
+	if (!success)
+		os_unlink(tmp.c_str());
+	return success;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <obs.h>
+
+/* Binary snapshot of the parsed config.json that is memory mapped at startup.
+ * The JSON file stays the source of truth: the snapshot records the size and
+ * FNV-1a hash of the JSON it was made from, and it is only used when those
+ * still match and its version and checksum are valid. */
+class ConfigCache {
+public:
+	/* returns nullptr when there is no valid snapshot for json_path */
+	static obs_data_t *Load(const char *json_path, const char *cache_path);
+	static bool Save(obs_data_t *config, const char *json_path, const char *cache_path);
+};
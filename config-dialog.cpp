@@ -124,9 +124,19 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	generalLayout->addRow(QString::fromUtf8(obs_module_text("Resolution")), resolution);
 
+	frameRate = new QComboBox;
+	generalLayout->addRow(QString::fromUtf8(obs_module_text("FrameRate")), frameRate);
+
 	showScenes = new QCheckBox(QString::fromUtf8(obs_module_text("ShowScenes")));
 	generalLayout->addWidget(showScenes);
 
+	renderCache = new QCheckBox(QString::fromUtf8(obs_module_text("RenderCache")));
+	generalLayout->addWidget(renderCache);
+
+	sharedTexture = new QCheckBox(QString::fromUtf8(obs_module_text("SharedTexture")));
+	generalLayout->addWidget(sharedTexture);
+	QObject::connect(renderCache, &QCheckBox::toggled, sharedTexture, &QCheckBox::setEnabled);
+
 	audioBitrate = new QComboBox;
 	audioBitrate->addItem("64", QVariant(64));
 	audioBitrate->addItem("96", QVariant(96));
@@ -150,6 +160,24 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	generalLayout->addRow(QString::fromUtf8(obs_frontend_get_locale_string("Basic.VCam.VirtualCamera")), virtualCameraMode);
 
+	virtualCameraResolution = new QComboBox;
+	virtualCameraResolution->setEditable(true);
+	virtualCameraResolution->addItem(QString::fromUtf8(obs_module_text("VirtualCameraResolutionCanvas")));
+	virtualCameraResolution->addItem("720x1280");
+	virtualCameraResolution->addItem("1080x1920");
+	virtualCameraResolution->addItem("1280x720");
+	virtualCameraResolution->addItem("1920x1080");
+	generalLayout->addRow(QString::fromUtf8(obs_module_text("VirtualCameraResolution")), virtualCameraResolution);
+
+#if defined(_WIN32) || defined(__APPLE__)
+	// only the format the virtual camera consumes, it then skips its own cpu conversion
+	virtualCameraFormat = new QComboBox;
+	virtualCameraFormat->addItem(QString::fromUtf8(obs_module_text("VirtualCameraFormatMain")), QVariant((int)VIDEO_FORMAT_NONE));
+	virtualCameraFormat->addItem(QString::fromUtf8(get_video_format_name(VIRTUAL_CAMERA_FORMAT)),
+				     QVariant((int)VIRTUAL_CAMERA_FORMAT));
+	generalLayout->addRow(QString::fromUtf8(obs_module_text("VirtualCameraFormat")), virtualCameraFormat);
+#endif
+
 	auto backtrackGroup = new QGroupBox;
 	backtrackGroup->setStyleSheet(QString("QGroupBox{ padding-top: 4px;}"));
 	auto backtrackLayout = new QFormLayout;
@@ -181,6 +209,29 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 	backtrackDuration->setMaximum(21600);
 	backtrackLayout->addRow(QString::fromUtf8(obs_module_text("BacktrackDuration")), backtrackDuration);
 
+	backtrackMaxSize = new QSpinBox;
+	backtrackMaxSize->setSuffix(" MB");
+	backtrackMaxSize->setMinimum(0);
+	backtrackMaxSize->setMaximum(1000000);
+	backtrackMaxSize->setSpecialValueText(QString::fromUtf8(obs_module_text("Unlimited")));
+	backtrackLayout->addRow(QString::fromUtf8(obs_module_text("BacktrackMaxSize")), backtrackMaxSize);
+
+	backtrackBudget = new QSpinBox;
+	backtrackBudget->setSuffix(" MB");
+	backtrackBudget->setMinimum(0);
+	backtrackBudget->setMaximum(1000000);
+	backtrackBudget->setSpecialValueText(QString::fromUtf8(obs_module_text("Unlimited")));
+	backtrackBudget->setToolTip(QString::fromUtf8(obs_module_text("BacktrackBudgetTooltip")));
+	backtrackLayout->addRow(QString::fromUtf8(obs_module_text("BacktrackBudget")), backtrackBudget);
+
+	backtrackDisk = new QCheckBox(QString::fromUtf8(obs_module_text("BacktrackDisk")));
+	backtrackDisk->setToolTip(QString::fromUtf8(obs_module_text("BacktrackDiskTooltip")));
+	connect(backtrackDisk, &QCheckBox::stateChanged, [this] {
+		backtrackMaxSize->setEnabled(!backtrackDisk->isChecked());
+		backtrackBudget->setEnabled(!backtrackDisk->isChecked());
+	});
+	backtrackLayout->addWidget(backtrackDisk);
+
 	QLayout *backtrackPathLayout = new QHBoxLayout;
 	backtrackPath = new QLineEdit();
 	backtrackPath->setReadOnly(true);
@@ -202,6 +253,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	backtrackLayout->addRow(QString::fromUtf8(obs_module_text("BacktrackPath")), backtrackPathLayout);
 
+	canvasDock->EnsureReplayOutput();
 	auto replayHotkeys = GetHotKeysFromOutput(canvasDock->replayOutput);
 
 	for (auto &hotkey : replayHotkeys) {
@@ -942,8 +994,36 @@ void OBSBasicSettings::LoadSettings()
 	}
 
 	resolution->setEnabled(enable);
+
+	// divisors of the main frame rate, encoders skip the frames in between
+	obs_video_info ovi;
+	obs_get_video_info(&ovi);
+	frameRate->clear();
+	for (uint32_t divisor = 1; divisor <= 4; divisor++) {
+		const double fps = (double)ovi.fps_num / (double)(ovi.fps_den * divisor);
+		frameRate->addItem(QString::number(fps, 'g', 4), QVariant(divisor));
+	}
+	int frameRateIndex = frameRate->findData(QVariant(canvasDock->fps_divisor));
+	frameRate->setCurrentIndex(frameRateIndex >= 0 ? frameRateIndex : 0);
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(30, 2, 0)
+	frameRate->setEnabled(enable);
+#else
+	frameRate->setEnabled(false);
+#endif
 	showScenes->setChecked(!canvasDock->hideScenes);
+	renderCache->setChecked(canvasDock->renderCache != nullptr);
+	sharedTexture->setChecked(canvasDock->sharedTexture);
+	sharedTexture->setEnabled(renderCache->isChecked());
 	virtualCameraMode->setCurrentIndex(canvasDock->virtual_cam_mode);
+	if (canvasDock->virtual_cam_width && canvasDock->virtual_cam_height)
+		virtualCameraResolution->setCurrentText(QString::number(canvasDock->virtual_cam_width) + "x" +
+							QString::number(canvasDock->virtual_cam_height));
+	else
+		virtualCameraResolution->setCurrentIndex(0);
+	if (virtualCameraFormat) {
+		int formatIndex = virtualCameraFormat->findData(QVariant((int)canvasDock->virtual_cam_format));
+		virtualCameraFormat->setCurrentIndex(formatIndex >= 0 ? formatIndex : 0);
+	}
 	recordVideoBitrate->setValue(canvasDock->recordVideoBitrate ? canvasDock->recordVideoBitrate : 6000);
 	recordingMatchMain->setChecked(canvasDock->recordingMatchMain);
 	streamingVideoBitrate->setValue(canvasDock->streamingVideoBitrate ? canvasDock->streamingVideoBitrate : 6000);
@@ -956,6 +1036,9 @@ void OBSBasicSettings::LoadSettings()
 	backtrackClip->setChecked(canvasDock->startReplay);
 	backtrackAlwaysOn->setChecked(canvasDock->replayAlwaysOn);
 	backtrackDuration->setValue(canvasDock->replayDuration);
+	backtrackMaxSize->setValue(canvasDock->replayMaxSize);
+	backtrackDisk->setChecked(canvasDock->replayDisk);
+	backtrackBudget->setValue(CanvasDock::GetBacktrackBudget());
 	backtrackPath->setText(QString::fromUtf8(canvasDock->replayPath));
 
 	for (size_t idx = 0; idx < canvasDock->streamOutputs.size(); idx++) {
@@ -1034,31 +1117,31 @@ void OBSBasicSettings::SaveSettings()
 			}
 		}
 	}
+	canvasDock->SetRenderCache(renderCache->isChecked());
+	canvasDock->sharedTexture = sharedTexture->isChecked();
 	const auto res = resolution->currentText();
 	uint32_t width, height;
 	if (sscanf(res.toUtf8().constData(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0 &&
 	    (width != canvasDock->canvas_width || height != canvasDock->canvas_height)) {
-		if (obs_output_active(canvasDock->replayOutput))
-			obs_output_stop(canvasDock->replayOutput);
-
-		blog(LOG_INFO, "[Vertical Canvas] resolution changed from %dx%d to %dx%d", canvasDock->canvas_width,
-		     canvasDock->canvas_height, width, height);
-
-		canvasDock->canvas_width = width;
-		canvasDock->canvas_height = height;
-
-		canvasDock->ResizeScenes();
-		auto t = obs_weak_source_get_source(canvasDock->source);
-		if (obs_source_get_type(t) == OBS_SOURCE_TYPE_TRANSITION) {
-			obs_transition_set_size(t, width, height);
-		}
-		obs_source_release(t);
-
-		canvasDock->LoadScenes();
-		canvasDock->ProfileChanged();
+		if (!canvasDock->SetResolution(width, height))
+			resolution->setCurrentText(QString::number(canvasDock->canvas_width) + "x" +
+						   QString::number(canvasDock->canvas_height));
 	}
+	if (frameRate->isEnabled() && frameRate->currentIndex() >= 0)
+		canvasDock->fps_divisor = frameRate->currentData().toUInt();
 	if (virtualCameraMode->currentIndex() >= 0)
 		canvasDock->virtual_cam_mode = virtualCameraMode->currentIndex();
+	// applied the next time the virtual camera starts
+	if (sscanf(virtualCameraResolution->currentText().toUtf8().constData(), "%ux%u", &width, &height) == 2 && width > 0 &&
+	    height > 0) {
+		canvasDock->virtual_cam_width = width;
+		canvasDock->virtual_cam_height = height;
+	} else {
+		canvasDock->virtual_cam_width = 0;
+		canvasDock->virtual_cam_height = 0;
+	}
+	canvasDock->virtual_cam_format = virtualCameraFormat ? (video_format)virtualCameraFormat->currentData().toInt()
+							     : VIDEO_FORMAT_NONE;
 
 	uint32_t bitrate = (uint32_t)recordVideoBitrate->value();
 	if (bitrate != canvasDock->recordVideoBitrate) {
@@ -1088,15 +1171,20 @@ void OBSBasicSettings::SaveSettings()
 	auto startReplay = backtrackClip->isChecked();
 	auto replayAlwaysOn = backtrackAlwaysOn->isChecked();
 	auto duration = (uint32_t)backtrackDuration->value();
+	auto maxSize = (uint32_t)backtrackMaxSize->value();
+	auto disk = backtrackDisk->isChecked();
 	std::string replayPath = backtrackPath->text().toUtf8().constData();
 	if (duration != canvasDock->replayDuration || replayPath != canvasDock->replayPath ||
-	    canvasDock->startReplay != startReplay || replayAlwaysOn != canvasDock->replayAlwaysOn) {
+	    canvasDock->startReplay != startReplay || replayAlwaysOn != canvasDock->replayAlwaysOn ||
+	    maxSize != canvasDock->replayMaxSize || disk != canvasDock->replayDisk) {
 		canvasDock->replayDuration = duration;
+		canvasDock->replayMaxSize = maxSize;
+		canvasDock->replayDisk = disk;
 		canvasDock->replayPath = replayPath;
 		canvasDock->startReplay = startReplay;
 		canvasDock->replayAlwaysOn = replayAlwaysOn;
 		if (replayAlwaysOn || startReplay) {
-			if (obs_output_active(canvasDock->replayOutput)) {
+			if (canvasDock->BacktrackActive()) {
 				canvasDock->StopReplayBuffer();
 				QTimer::singleShot(500, this, [this] { canvasDock->CheckReplayBuffer(true); });
 			} else {
@@ -1106,6 +1194,9 @@ void OBSBasicSettings::SaveSettings()
 			canvasDock->StopReplayBuffer();
 		}
 	}
+	// bitrate, duration and backtrack changes above move the shares of the other canvases too,
+	// running backtracks use their new share from their next start
+	CanvasDock::SetBacktrackBudget((uint32_t)backtrackBudget->value());
 
 	int enabled_count = 0;
 	int active_count = 0;
@@ -1116,9 +1207,6 @@ void OBSBasicSettings::SaveSettings()
 			StreamServer so;
 			so.stream_server = ss;
 			so.stream_key = sk;
-			std::string service_name = "vertical_canvas_stream_service_";
-			service_name += std::to_string(idx);
-			so.service = obs_service_create("rtmp_custom", service_name.c_str(), nullptr, nullptr);
 			canvasDock->streamOutputs.push_back(so);
 		} else if (obs_output_active(canvasDock->streamOutputs[idx].output)) {
 			active_count++;
@@ -31,16 +31,24 @@ private:
 	QLabel *newVersion;
 	QListWidget *listWidget;
 	QComboBox *resolution;
+	QComboBox *frameRate;
 	QCheckBox *showScenes;
+	QCheckBox *renderCache;
+	QCheckBox *sharedTexture;
 	QSpinBox *streamingVideoBitrate;
 	QCheckBox *streamingMatchMain;
 	QSpinBox *recordVideoBitrate;
 	QCheckBox *recordingMatchMain;
 	QComboBox *audioBitrate;
 	QComboBox *virtualCameraMode;
+	QComboBox *virtualCameraResolution;
+	QComboBox *virtualCameraFormat = nullptr;
 	QCheckBox *backtrackClip;
 	QCheckBox *backtrackAlwaysOn;
 	QSpinBox *backtrackDuration;
+	QSpinBox *backtrackMaxSize;
+	QSpinBox *backtrackBudget;
+	QCheckBox *backtrackDisk;
 	QLineEdit *backtrackPath;
 
 	QFormLayout *streamingLayout;
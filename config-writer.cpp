@@ -0,0 +1,105 @@
+#include "config-writer.hpp"
+#include "config-cache.hpp"
+
+#include "util/platform.h"
+#include "util/threading.h"
+
+ConfigWriter::ConfigWriter(std::string path_, std::string cache_path_)
+	: path(std::move(path_)),
+	  cachePath(std::move(cache_path_))
+{
+	thread = std::thread([this] { Run(); });
+}
+
+ConfigWriter::~ConfigWriter()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	if (thread.joinable())
+		thread.join();
+	obs_data_release(pending);
+}
+
+void ConfigWriter::Queue(obs_data_t *config)
+{
+	obs_data_addref(config);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		// an older snapshot that was not written yet is outdated
+		obs_data_release(pending);
+		pending = config;
+	}
+	condition.notify_all();
+}
+
+void ConfigWriter::Flush()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this] { return !pending && !writing; });
+}
+
+void ConfigWriter::Run()
+{
+	os_set_thread_name("vertical-canvas: config writer");
+	for (;;) {
+		obs_data_t *config;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return stopping || pending; });
+			// write what is pending before stopping, it is the state at exit
+			if (!pending)
+				return;
+			config = pending;
+			pending = nullptr;
+			writing = true;
+		}
+		Write(config);
+		obs_data_release(config);
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			writing = false;
+		}
+		condition.notify_all();
+	}
+}
+
+void ConfigWriter::Write(obs_data_t *config)
+{
+	std::vector<std::string> blocks;
+	int changed = 0;
+	obs_data_array_t *canvas = obs_data_get_array(config, "canvas");
+	const size_t count = obs_data_array_count(canvas);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(canvas, i);
+		const char *json = obs_data_get_json(item);
+		blocks.emplace_back(json ? json : "");
+		obs_data_release(item);
+		if (i >= writtenBlocks.size() || writtenBlocks[i] != blocks.back())
+			changed++;
+	}
+	obs_data_array_release(canvas);
+
+	obs_data_t *root = obs_data_create();
+	obs_data_apply(root, config);
+	obs_data_erase(root, "canvas");
+	const char *root_json = obs_data_get_json(root);
+	std::string rootJson = root_json ? root_json : "";
+	obs_data_release(root);
+
+	if (!changed && count == writtenBlocks.size() && rootJson == writtenRoot)
+		return;
+
+	const char *json = obs_data_get_json(config);
+	if (json && os_quick_write_utf8_file_safe(path.c_str(), json, strlen(json), false, "tmp", "bak")) {
+		writtenBlocks = std::move(blocks);
+		writtenRoot = std::move(rootJson);
+		if (!ConfigCache::Save(config, path.c_str(), cachePath.c_str()))
+			blog(LOG_WARNING, "[Vertical Canvas] Failed saving config cache");
+		blog(LOG_INFO, "[Vertical Canvas] Saved settings, %d of %d canvas changed", changed, (int)count);
+	} else {
+		blog(LOG_ERROR, "[Vertical Canvas] Failed saving settings");
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <obs.h>
+
+/* Writes the plugin configuration on a worker thread.
+ * Snapshots are taken on the UI thread and handed over, only the newest one
+ * that is still pending gets written. Every canvas block is compared with what
+ * was written last, a snapshot without changed blocks is not written at all.
+ * The file is replaced atomically with a backup of the previous version, then
+ * the binary startup cache is refreshed from the same snapshot. */
+class ConfigWriter {
+public:
+	ConfigWriter(std::string path, std::string cache_path);
+	~ConfigWriter();
+
+	void Queue(obs_data_t *config);
+	void Flush();
+
+private:
+	std::string path;
+	std::string cachePath;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	obs_data_t *pending = nullptr;
+	bool writing = false;
+	bool stopping = false;
+	std::vector<std::string> writtenBlocks;
+	std::string writtenRoot;
+
+	void Run();
+	void Write(obs_data_t *config);
+};
@@ -0,0 +1,137 @@
+#include "disk-backtrack.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "util/dstr.h"
+#include "util/platform.h"
+
+DiskBacktrack::DiskBacktrack(const char *name, std::string spool_dir) : spool(std::move(spool_dir))
+{
+	output = obs_output_create("ffmpeg_muxer", name, nullptr, nullptr);
+	auto sh = obs_output_get_signal_handler(output);
+	signal_handler_connect(sh, "file_changed", file_changed, this);
+}
+
+DiskBacktrack::~DiskBacktrack()
+{
+	auto sh = obs_output_get_signal_handler(output);
+	signal_handler_disconnect(sh, "file_changed", file_changed, this);
+	Stop();
+	obs_output_release(output);
+	ClearSpool();
+}
+
+bool DiskBacktrack::Active() const
+{
+	return obs_output_active(output);
+}
+
+bool DiskBacktrack::Saving() const
+{
+	return saver.Busy();
+}
+
+void DiskBacktrack::ClearSpool()
+{
+	if (saver.Busy())
+		return;
+	os_dir_t *dir = os_opendir(spool.c_str());
+	if (!dir)
+		return;
+	struct os_dirent *ent;
+	while ((ent = os_readdir(dir)) != nullptr) {
+		if (ent->directory)
+			continue;
+		const char *ext = os_get_path_extension(ent->d_name);
+		if (!ext || astrcmpi(ext, ".ts") != 0)
+			continue;
+		std::string file = spool + "/" + ent->d_name;
+		os_unlink(file.c_str());
+	}
+	os_closedir(dir);
+}
+
+bool DiskBacktrack::Start(uint32_t window_sec)
+{
+	if (Active())
+		return true;
+
+	window = window_sec ? window_sec : 5;
+	const uint32_t segment_sec = std::clamp(window / 10, 2u, 60u);
+
+	os_mkdirs(spool.c_str());
+	ClearSpool();
+
+	const char *format = "segment %CCYY-%MM-%DD %hh-%mm-%ss";
+	char *filename = os_generate_formatted_filename("ts", true, format);
+	std::string path = spool + "/" + filename;
+	bfree(filename);
+
+	obs_data_t *s = obs_data_create();
+	obs_data_set_string(s, "path", path.c_str());
+	obs_data_set_string(s, "directory", spool.c_str());
+	obs_data_set_string(s, "format", format);
+	obs_data_set_string(s, "extension", "ts");
+	obs_data_set_bool(s, "allow_spaces", true);
+	obs_data_set_bool(s, "allow_overwrite", false);
+	obs_data_set_bool(s, "split_file", true);
+	obs_data_set_int(s, "max_time_sec", segment_sec);
+	obs_data_set_int(s, "max_size_mb", 0);
+	obs_data_set_bool(s, "reset_timestamps", false);
+	obs_output_update(output, s);
+	obs_data_release(s);
+
+	{
+		std::unique_lock<std::mutex> lock(segmentsMutex);
+		segments.clear();
+		segments.push_back({path, os_gettime_ns()});
+	}
+
+	blog(LOG_INFO, "[Vertical Canvas] disk backtrack started, %u s window in %u s segments", window, segment_sec);
+	return obs_output_start(output);
+}
+
+void DiskBacktrack::Stop()
+{
+	if (obs_output_active(output))
+		obs_output_stop(output);
+}
+
+void DiskBacktrack::TrimSegments(uint64_t now)
+{
+	// segments queued for saving must stay until the saver is done with them
+	if (saver.Busy())
+		return;
+	const uint64_t window_ns = (uint64_t)window * 1000000000ULL;
+	// keep the segment the window starts in, it starts on a keyframe
+	while (segments.size() > 1 && segments[1].start_ns + window_ns <= now) {
+		os_unlink(segments.front().path.c_str());
+		segments.pop_front();
+	}
+}
+
+void DiskBacktrack::file_changed(void *data, calldata_t *calldata)
+{
+	auto db = static_cast<DiskBacktrack *>(data);
+	const char *next_file = calldata_string(calldata, "next_file");
+	if (!next_file || !*next_file)
+		return;
+	const uint64_t now = os_gettime_ns();
+	std::unique_lock<std::mutex> lock(db->segmentsMutex);
+	db->segments.push_back({next_file, now});
+	db->TrimSegments(now);
+}
+
+bool DiskBacktrack::Save(std::string path, BacktrackSaver::ProgressCallback progress, BacktrackSaver::DoneCallback done)
+{
+	// queued while holding the lock so TrimSegments sees the saver busy before it can unlink these
+	std::unique_lock<std::mutex> lock(segmentsMutex);
+	std::vector<std::string> files;
+	for (const auto &segment : segments)
+		files.push_back(segment.path);
+	if (files.empty())
+		return false;
+	saver.SaveSegments(std::move(files), std::move(path), std::move(progress), std::move(done));
+	return true;
+}
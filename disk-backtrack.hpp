@@ -0,0 +1,46 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <obs.h>
+
+#include "backtrack-saver.hpp"
+
+/* Backtrack that keeps its window on disk instead of in memory.
+ * The encoded packets are written by an ffmpeg_muxer output as MPEG-TS
+ * segments that always start on a keyframe. The segments form a ring: the
+ * ones that fell out of the window are deleted as new ones are started.
+ * Saving hands the segments that cover the window to the backtrack saver,
+ * MPEG-TS segments can be joined byte by byte. */
+class DiskBacktrack {
+public:
+	DiskBacktrack(const char *name, std::string spool_dir);
+	~DiskBacktrack();
+
+	inline obs_output_t *GetOutput() const { return output; }
+	bool Active() const;
+	bool Saving() const;
+
+	bool Start(uint32_t window_sec);
+	void Stop();
+	bool Save(std::string path, BacktrackSaver::ProgressCallback progress, BacktrackSaver::DoneCallback done);
+
+private:
+	struct Segment {
+		std::string path;
+		uint64_t start_ns;
+	};
+
+	obs_output_t *output = nullptr;
+	std::string spool;
+	uint32_t window = 0;
+	mutable std::mutex segmentsMutex;
+	std::deque<Segment> segments;
+	BacktrackSaver saver;
+
+	void ClearSpool();
+	void TrimSegments(uint64_t now);
+	static void file_changed(void *data, calldata_t *calldata);
+};
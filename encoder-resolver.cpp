@@ -0,0 +1,387 @@
+#include "encoder-resolver.hpp"
+
+#include <cmath>
+#include <mutex>
+#include <sys/stat.h>
+
+#include <obs-frontend-api.h>
+#include "util/config-file.h"
+#include "util/dstr.h"
+#include "util/platform.h"
+#include "util/util.hpp"
+
+int GetConfigPath(char *path, size_t size, const char *name);
+
+bool EncoderAvailable(const char *encoder)
+{
+	const char *val;
+	int i = 0;
+
+	while (obs_enum_encoder_types(i++, &val))
+		if (strcmp(val, encoder) == 0)
+			return true;
+
+	return false;
+}
+
+const char *get_simple_output_encoder(const char *encoder)
+{
+	if (strcmp(encoder, SIMPLE_ENCODER_X264) == 0)
+		return "obs_x264";
+	if (strcmp(encoder, SIMPLE_ENCODER_X264_LOWCPU) == 0)
+		return "obs_x264";
+	if (strcmp(encoder, SIMPLE_ENCODER_QSV) == 0)
+		return "obs_qsv11_v2";
+	if (strcmp(encoder, SIMPLE_ENCODER_QSV_AV1) == 0)
+		return "obs_qsv11_av1";
+	if (strcmp(encoder, SIMPLE_ENCODER_AMD) == 0)
+		return "h264_texture_amf";
+	if (strcmp(encoder, SIMPLE_ENCODER_AMD_HEVC) == 0)
+		return "h265_texture_amf";
+	if (strcmp(encoder, SIMPLE_ENCODER_AMD_AV1) == 0)
+		return "av1_texture_amf";
+	if (strcmp(encoder, SIMPLE_ENCODER_NVENC) == 0)
+		return EncoderAvailable("jim_nvenc") ? "jim_nvenc" : "ffmpeg_nvenc";
+	if (strcmp(encoder, SIMPLE_ENCODER_NVENC_HEVC) == 0)
+		return EncoderAvailable("jim_hevc_nvenc") ? "jim_hevc_nvenc" : "ffmpeg_hevc_nvenc";
+	if (strcmp(encoder, SIMPLE_ENCODER_NVENC_AV1) == 0)
+		return "jim_av1_nvenc";
+	if (strcmp(encoder, SIMPLE_ENCODER_APPLE_H264) == 0)
+		return "com.apple.videotoolbox.videoencoder.ave.avc";
+	if (strcmp(encoder, SIMPLE_ENCODER_APPLE_HEVC) == 0)
+		return "com.apple.videotoolbox.videoencoder.ave.hevc";
+	return "obs_x264";
+}
+
+const char *get_simple_output_preset_type(const char *encoder)
+{
+	if (!encoder)
+		return "Preset";
+	if (strcmp(encoder, SIMPLE_ENCODER_QSV) == 0 || strcmp(encoder, SIMPLE_ENCODER_QSV_AV1) == 0)
+		return "QSVPreset";
+	if (strcmp(encoder, SIMPLE_ENCODER_AMD) == 0 || strcmp(encoder, SIMPLE_ENCODER_AMD_HEVC) == 0)
+		return "AMDPreset";
+	if (strcmp(encoder, SIMPLE_ENCODER_AMD_AV1) == 0)
+		return "AMDAV1Preset";
+	if (strcmp(encoder, SIMPLE_ENCODER_NVENC) == 0 || strcmp(encoder, SIMPLE_ENCODER_NVENC_HEVC) == 0 ||
+	    strcmp(encoder, SIMPLE_ENCODER_NVENC_AV1) == 0)
+		return "NVENCPreset2";
+	return "Preset";
+}
+
+static inline int GetProfilePath(char *path, size_t size, const char *file)
+{
+	char profiles_path[512];
+	config_t *config = obs_frontend_get_global_config();
+	if (!config)
+		return -1;
+	const char *profile = config_get_string(config, "Basic", "ProfileDir");
+
+	if (!profile)
+		return -1;
+	if (!path)
+		return -1;
+	if (!file)
+		file = "";
+
+	int ret = GetConfigPath(profiles_path, 512, "obs-studio/basic/profiles");
+	if (ret <= 0)
+		return ret;
+
+	if (!*file)
+		return snprintf(path, size, "%s/%s", profiles_path, profile);
+
+	return snprintf(path, size, "%s/%s/%s", profiles_path, profile, file);
+}
+
+static obs_data_t *GetDataFromJsonFile(const char *jsonFile)
+{
+	char fullPath[512];
+	obs_data_t *data = nullptr;
+
+	int ret = GetProfilePath(fullPath, sizeof(fullPath), jsonFile);
+	if (ret > 0) {
+		BPtr<char> jsonData = os_quick_read_utf8_file(fullPath);
+		if (!!jsonData) {
+			data = obs_data_create_from_json(jsonData);
+		}
+	}
+
+	if (!data)
+		data = obs_data_create();
+
+	return data;
+}
+
+struct ResolverCache {
+	std::string signature;
+	obs_data_t *stream_encoder = nullptr;
+	obs_data_t *record_encoder = nullptr;
+	obs_data_t *replay = nullptr;
+	bool replay_resolved = false;
+	std::string aac_encoder;
+};
+
+static std::mutex cache_mutex;
+static ResolverCache cache;
+
+static void AppendModifiedTime(std::string &signature, const char *file)
+{
+	char path[512];
+	struct stat st;
+	signature += "|";
+	if (GetProfilePath(path, sizeof(path), file) > 0 && os_stat(path, &st) == 0)
+		signature += std::to_string((int64_t)st.st_mtime);
+}
+
+static void ClearCache()
+{
+	obs_data_release(cache.stream_encoder);
+	obs_data_release(cache.record_encoder);
+	obs_data_release(cache.replay);
+	cache = ResolverCache();
+}
+
+// must be called with cache_mutex locked
+static void RefreshCache()
+{
+	config_t *global = obs_frontend_get_global_config();
+	const char *profile = global ? config_get_string(global, "Basic", "ProfileDir") : nullptr;
+	std::string signature = profile ? profile : "";
+	AppendModifiedTime(signature, "basic.ini");
+	AppendModifiedTime(signature, "streamEncoder.json");
+	AppendModifiedTime(signature, "recordEncoder.json");
+	if (signature == cache.signature)
+		return;
+	ClearCache();
+	cache.signature = signature;
+}
+
+static obs_data_t *CopyData(obs_data_t *data)
+{
+	obs_data_t *copy = obs_data_create();
+	obs_data_apply(copy, data);
+	return copy;
+}
+
+obs_data_t *EncoderResolver::GetStreamEncoderSettings()
+{
+	std::unique_lock<std::mutex> lock(cache_mutex);
+	RefreshCache();
+	if (!cache.stream_encoder)
+		cache.stream_encoder = GetDataFromJsonFile("streamEncoder.json");
+	return CopyData(cache.stream_encoder);
+}
+
+static int CalcCRF(int crf, uint32_t cx, uint32_t cy)
+{
+	// same resolution scaling as the simple output mode of the frontend
+	const double crossDist = std::sqrt((double)cx * (double)cx + (double)cy * (double)cy);
+	double crfResReduction = std::fmin(2000.0, crossDist) / 2000.0;
+	crfResReduction = (1.0 - crfResReduction) * 10.0;
+	return crf - (int)crfResReduction;
+}
+
+bool EncoderResolver::GetRecordVideo(std::string &encoder_id, obs_data_t **settings, uint32_t cx, uint32_t cy)
+{
+	config_t *config = obs_frontend_get_profile_config();
+	const char *mode = config_get_string(config, "Output", "Mode");
+	if (mode && strcmp(mode, "Advanced") == 0) {
+		const char *recordEncoder = config_get_string(config, "AdvOut", "RecEncoder");
+		if (!recordEncoder || astrcmpi(recordEncoder, "none") == 0)
+			return false;
+		encoder_id = recordEncoder;
+		std::unique_lock<std::mutex> lock(cache_mutex);
+		RefreshCache();
+		if (!cache.record_encoder)
+			cache.record_encoder = GetDataFromJsonFile("recordEncoder.json");
+		*settings = CopyData(cache.record_encoder);
+		return true;
+	}
+
+	const char *quality = config_get_string(config, "SimpleOutput", "RecQuality");
+	if (!quality || strcmp(quality, "Stream") == 0 || strcmp(quality, "Lossless") == 0)
+		return false;
+	const char *encoder = config_get_string(config, "SimpleOutput", "RecEncoder");
+	if (!encoder)
+		encoder = SIMPLE_ENCODER_X264;
+	encoder_id = get_simple_output_encoder(encoder);
+
+	const bool ultra_hq = strcmp(quality, "HQ") == 0;
+	const int crf = CalcCRF(ultra_hq ? 16 : 23, cx, cy);
+	obs_data_t *s = obs_data_create();
+	if (astrcmp_n(encoder, SIMPLE_ENCODER_X264, 4) == 0) {
+		obs_data_set_int(s, "crf", crf);
+		obs_data_set_bool(s, "use_bufsize", true);
+		obs_data_set_string(s, "rate_control", "CRF");
+		obs_data_set_string(s, "profile", "high");
+	} else if (strcmp(encoder, SIMPLE_ENCODER_APPLE_H264) == 0 || strcmp(encoder, SIMPLE_ENCODER_APPLE_HEVC) == 0) {
+		obs_data_set_string(s, "rate_control", "CRF");
+		obs_data_set_string(s, "profile", "high");
+		obs_data_set_int(s, "quality", ultra_hq ? 70 : 50);
+	} else {
+		obs_data_set_string(s, "rate_control", "CQP");
+		obs_data_set_int(s, "cqp", crf);
+		if (strcmp(encoder, SIMPLE_ENCODER_QSV) == 0) {
+			obs_data_set_int(s, "qpi", crf);
+			obs_data_set_int(s, "qpp", crf);
+			obs_data_set_int(s, "qpb", crf);
+		}
+	}
+	// the preset the user picked for the encoder, the low cpu x264 option implies ultrafast
+	const char *preset_type = get_simple_output_preset_type(encoder);
+	const char *preset = config_get_string(config, "SimpleOutput", preset_type);
+	if (strcmp(encoder, SIMPLE_ENCODER_X264_LOWCPU) == 0)
+		preset = "ultrafast";
+	else if (strcmp(preset_type, "Preset") == 0 && (!preset || !*preset))
+		preset = "veryfast";
+	if (preset && *preset)
+		obs_data_set_string(s, strcmp(preset_type, "NVENCPreset2") == 0 ? "preset2" : "preset", preset);
+	*settings = s;
+	return true;
+}
+
+uint32_t EncoderResolver::GetRecordMixers()
+{
+	config_t *config = obs_frontend_get_profile_config();
+	const char *mode = config_get_string(config, "Output", "Mode");
+	uint32_t mixers;
+	if (mode && astrcmpi(mode, "Advanced") == 0) {
+		const char *recType = config_get_string(config, "AdvOut", "RecType");
+		if (recType && astrcmpi(recType, "FFmpeg") == 0) {
+			mixers = (uint32_t)config_get_int(config, "AdvOut", "FFAudioMixes");
+		} else {
+			mixers = (uint32_t)config_get_int(config, "AdvOut", "RecTracks");
+		}
+	} else {
+		const char *quality = config_get_string(config, "SimpleOutput", "RecQuality");
+		if (quality && strcmp(quality, "Stream") == 0) {
+			mixers = 1;
+		} else {
+			mixers = (uint32_t)config_get_int(config, "SimpleOutput", "RecTracks");
+		}
+	}
+	if (!mixers)
+		mixers = 1;
+	return mixers;
+}
+
+static const char *GetAACEncoder()
+{
+	if (cache.aac_encoder.empty()) {
+		if (EncoderAvailable("libfdk_aac"))
+			cache.aac_encoder = "libfdk_aac";
+		else if (EncoderAvailable("CoreAudio_AAC"))
+			cache.aac_encoder = "CoreAudio_AAC";
+		else
+			cache.aac_encoder = "ffmpeg_aac";
+	}
+	return cache.aac_encoder.c_str();
+}
+
+obs_data_t *EncoderResolver::GetRecordAudio(std::string &encoder_id, size_t mix_idx)
+{
+	config_t *config = obs_frontend_get_profile_config();
+	const char *mode = config_get_string(config, "Output", "Mode");
+	obs_data_t *s = obs_data_create();
+	std::unique_lock<std::mutex> lock(cache_mutex);
+	RefreshCache();
+	if (mode && astrcmpi(mode, "Advanced") == 0) {
+		const char *id = config_get_string(config, "AdvOut", "RecAudioEncoder");
+		if (!id || !*id)
+			id = config_get_string(config, "AdvOut", "AudioEncoder");
+		encoder_id = id && *id ? id : GetAACEncoder();
+		static const char *trackNames[] = {
+			"Track1Bitrate", "Track2Bitrate", "Track3Bitrate", "Track4Bitrate", "Track5Bitrate", "Track6Bitrate",
+		};
+		if (mix_idx < 6)
+			obs_data_set_int(s, "bitrate", (int)config_get_uint(config, "AdvOut", trackNames[mix_idx]));
+	} else {
+		const char *id = config_get_string(config, "SimpleOutput", "RecAudioEncoder");
+		encoder_id = id && strcmp(id, "opus") == 0 ? "ffmpeg_opus" : GetAACEncoder();
+		obs_data_set_string(s, "rate_control", "CBR");
+		obs_data_set_int(s, "bitrate", (int)config_get_uint(config, "SimpleOutput", "ABitrate"));
+	}
+	return s;
+}
+
+static std::string GetFormatExt(const char *container)
+{
+	std::string ext = container ? container : "mkv";
+	if (ext == "fragmented_mp4" || ext == "hybrid_mp4")
+		ext = "mp4";
+	else if (ext == "fragmented_mov" || ext == "hybrid_mov")
+		ext = "mov";
+	else if (ext == "hls")
+		ext = "m3u8";
+	else if (ext == "mpegts")
+		ext = "ts";
+	return ext;
+}
+
+static std::string GetFormatString(const char *format, const char *prefix, const char *suffix)
+{
+	std::string f = format ? format : "%CCYY-%MM-%DD %hh-%mm-%ss";
+	if (prefix && *prefix) {
+		std::string p = prefix;
+		if (p.back() != ' ')
+			p += " ";
+		f.insert(0, p);
+	}
+	if (suffix && *suffix) {
+		if (*suffix != ' ')
+			f += " ";
+		f += suffix;
+	}
+	return f;
+}
+
+obs_data_t *EncoderResolver::GetReplaySettings()
+{
+	std::unique_lock<std::mutex> lock(cache_mutex);
+	RefreshCache();
+	if (cache.replay_resolved)
+		return cache.replay ? CopyData(cache.replay) : nullptr;
+	cache.replay_resolved = true;
+
+	config_t *config = obs_frontend_get_profile_config();
+	const char *mode = config_get_string(config, "Output", "Mode");
+	const bool advanced = mode && astrcmpi(mode, "Advanced") == 0;
+	const char *section = advanced ? "AdvOut" : "SimpleOutput";
+	if (advanced) {
+		const char *recType = config_get_string(config, "AdvOut", "RecType");
+		if (recType && astrcmpi(recType, "FFmpeg") == 0)
+			return nullptr;
+	} else {
+		const char *quality = config_get_string(config, "SimpleOutput", "RecQuality");
+		if (quality && strcmp(quality, "Lossless") == 0)
+			return nullptr;
+	}
+
+	const char *container = config_has_user_value(config, section, "RecFormat2") ||
+						!config_has_user_value(config, section, "RecFormat")
+					? config_get_string(config, section, "RecFormat2")
+					: config_get_string(config, section, "RecFormat");
+
+	obs_data_t *s = obs_data_create();
+	obs_data_set_string(s, "directory", config_get_string(config, section, advanced ? "RecFilePath" : "FilePath"));
+	obs_data_set_string(s, "format",
+			    GetFormatString(config_get_string(config, "Output", "FilenameFormatting"),
+					    config_get_string(config, section, "RecRBPrefix"),
+					    config_get_string(config, section, "RecRBSuffix"))
+				    .c_str());
+	obs_data_set_string(s, "extension", GetFormatExt(container).c_str());
+	obs_data_set_bool(s, "allow_spaces",
+			  !config_get_bool(config, section, advanced ? "RecFileNameWithoutSpace" : "FileNameWithoutSpace"));
+	obs_data_set_string(s, "muxer_settings", config_get_string(config, section, advanced ? "RecMuxerCustom" : "MuxerCustom"));
+	obs_data_set_int(s, "max_time_sec", config_get_int(config, section, "RecRBTime"));
+	obs_data_set_int(s, "max_size_mb", config_get_int(config, section, "RecRBSize"));
+	cache.replay = s;
+	return CopyData(s);
+}
+
+void EncoderResolver::Invalidate()
+{
+	std::unique_lock<std::mutex> lock(cache_mutex);
+	ClearCache();
+}
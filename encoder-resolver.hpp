@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+#include <obs.h>
+
+#define SIMPLE_ENCODER_X264 "x264"
+#define SIMPLE_ENCODER_X264_LOWCPU "x264_lowcpu"
+#define SIMPLE_ENCODER_QSV "qsv"
+#define SIMPLE_ENCODER_QSV_AV1 "qsv_av1"
+#define SIMPLE_ENCODER_NVENC "nvenc"
+#define SIMPLE_ENCODER_NVENC_AV1 "nvenc_av1"
+#define SIMPLE_ENCODER_NVENC_HEVC "nvenc_hevc"
+#define SIMPLE_ENCODER_AMD "amd"
+#define SIMPLE_ENCODER_AMD_HEVC "amd_hevc"
+#define SIMPLE_ENCODER_AMD_AV1 "amd_av1"
+#define SIMPLE_ENCODER_APPLE_H264 "apple_h264"
+#define SIMPLE_ENCODER_APPLE_HEVC "apple_hevc"
+
+bool EncoderAvailable(const char *encoder);
+const char *get_simple_output_encoder(const char *encoder);
+/* SimpleOutput config key that holds the preset of a simple output encoder */
+const char *get_simple_output_preset_type(const char *encoder);
+
+/* Derives the encoder and replay buffer configuration the main outputs would
+ * use straight from the profile config, so the main outputs never have to be
+ * started to create their encoders. Results are cached until the profile or
+ * its config files change. Returned obs_data_t must be released. */
+class EncoderResolver {
+public:
+	static obs_data_t *GetStreamEncoderSettings();
+	/* returns false when recording uses the stream encoder */
+	static bool GetRecordVideo(std::string &encoder_id, obs_data_t **settings, uint32_t cx, uint32_t cy);
+	static uint32_t GetRecordMixers();
+	static obs_data_t *GetRecordAudio(std::string &encoder_id, size_t mix_idx);
+	/* returns nullptr when recording is a custom ffmpeg output */
+	static obs_data_t *GetReplaySettings();
+	static void Invalidate();
+};
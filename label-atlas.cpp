@@ -0,0 +1,112 @@
+#include "label-atlas.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+
+#define LABEL_ATLAS_OUTLINE 3
+#define LABEL_ATLAS_PADDING 1
+
+LabelAtlas::LabelAtlas(int font_size)
+{
+#if defined(_WIN32)
+	QFont font(QStringLiteral("Arial"));
+#elif defined(__APPLE__)
+	QFont font(QStringLiteral("Helvetica"));
+#else
+	QFont font(QStringLiteral("Monospace"));
+#endif
+	font.setPixelSize(font_size);
+	font.setBold(true);
+	const QFontMetrics fm(font);
+
+	const char *chars = LABEL_ATLAS_CHARS;
+	const size_t count = strlen(chars);
+	uint32_t x = 0;
+	for (size_t i = 0; i < count; i++) {
+		Glyph &g = glyphs[(unsigned char)chars[i]];
+		g.advance = (float)fm.horizontalAdvance(QChar::fromLatin1(chars[i]));
+		g.x = x;
+		g.cx = (uint32_t)std::ceil(g.advance) + LABEL_ATLAS_OUTLINE * 2;
+		g.valid = true;
+		x += g.cx + LABEL_ATLAS_PADDING;
+	}
+	cx = x;
+	cy = (uint32_t)fm.height() + LABEL_ATLAS_OUTLINE * 2;
+
+	QImage image((int)cx, (int)cy, QImage::Format_RGBA8888);
+	image.fill(Qt::transparent);
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+	QPen outline(Qt::black, LABEL_ATLAS_OUTLINE, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+	for (size_t i = 0; i < count; i++) {
+		const Glyph &g = glyphs[(unsigned char)chars[i]];
+		QPainterPath path;
+		path.addText(QPointF(g.x + LABEL_ATLAS_OUTLINE, LABEL_ATLAS_OUTLINE + fm.ascent()), font,
+			     QString(QChar::fromLatin1(chars[i])));
+		painter.strokePath(path, outline);
+		painter.fillPath(path, Qt::white);
+	}
+	painter.end();
+
+	pixels.resize((size_t)cx * cy * 4);
+	for (uint32_t y = 0; y < cy; y++)
+		memcpy(pixels.data() + (size_t)y * cx * 4, image.constScanLine((int)y), (size_t)cx * 4);
+}
+
+LabelAtlas::~LabelAtlas()
+{
+	if (!texture)
+		return;
+	obs_enter_graphics();
+	gs_texture_destroy(texture);
+	obs_leave_graphics();
+}
+
+float LabelAtlas::Width(const char *text) const
+{
+	float width = LABEL_ATLAS_OUTLINE * 2;
+	for (const char *c = text; *c; c++) {
+		const Glyph &g = glyphs[*c & 0x7f];
+		if (g.valid)
+			width += g.advance;
+	}
+	return width;
+}
+
+void LabelAtlas::Draw(const char *text)
+{
+	if (!texture) {
+		const uint8_t *data = pixels.data();
+		texture = gs_texture_create(cx, cy, GS_RGBA, 1, &data, 0);
+		if (!texture)
+			return;
+	}
+
+	gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), texture);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+	gs_matrix_push();
+	while (gs_effect_loop(effect, "Draw")) {
+		float x = 0.0f;
+		for (const char *c = text; *c; c++) {
+			const Glyph &g = glyphs[*c & 0x7f];
+			if (!g.valid)
+				continue;
+			gs_matrix_push();
+			gs_matrix_translate3f(std::floor(x), 0.0f, 0.0f);
+			gs_draw_sprite_subregion(texture, 0, g.x, 0, g.cx, cy);
+			gs_matrix_pop();
+			x += g.advance;
+		}
+	}
+	gs_matrix_pop();
+	gs_blend_state_pop();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <obs.h>
+
+#define LABEL_ATLAS_CHARS "0123456789 px-"
+
+/* Pre-rasterized glyphs for the spacing helper labels.
+ * The glyphs are painted once on the UI thread, the texture is created on
+ * first draw in the graphics thread and labels are drawn as textured quads,
+ * so changing a label does not touch a text source or the font rasterizer. */
+class LabelAtlas {
+public:
+	LabelAtlas(int font_size);
+	~LabelAtlas();
+
+	float Width(const char *text) const;
+	inline float Height() const { return (float)cy; }
+
+	/* draws at the current matrix position, must be called in the graphics context */
+	void Draw(const char *text);
+
+private:
+	struct Glyph {
+		uint32_t x = 0;
+		uint32_t cx = 0;
+		float advance = 0.0f;
+		bool valid = false;
+	};
+
+	Glyph glyphs[128];
+	std::vector<uint8_t> pixels;
+	uint32_t cx = 0;
+	uint32_t cy = 0;
+	gs_texture_t *texture = nullptr;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <util/threading.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* must be a power of two */
+#define METRICS_RING_SIZE 1024
+
+/* single producer single consumer ring, the producer is the thread being
+ * measured (graphics, audio) and never blocks, samples are dropped when the
+ * consumer falls behind */
+struct metrics_ring {
+	volatile long head;
+	volatile long tail;
+	volatile long dropped;
+	uint64_t values[METRICS_RING_SIZE];
+};
+
+static inline void metrics_ring_push(struct metrics_ring *ring, uint64_t value)
+{
+	if (!ring)
+		return;
+	unsigned long head = (unsigned long)os_atomic_load_long(&ring->head);
+	unsigned long tail = (unsigned long)os_atomic_load_long(&ring->tail);
+	if (head - tail >= METRICS_RING_SIZE) {
+		os_atomic_inc_long(&ring->dropped);
+		return;
+	}
+	ring->values[head & (METRICS_RING_SIZE - 1)] = value;
+	os_atomic_set_long(&ring->head, (long)(head + 1));
+}
+
+static inline bool metrics_ring_pop(struct metrics_ring *ring, uint64_t *value)
+{
+	unsigned long tail = (unsigned long)os_atomic_load_long(&ring->tail);
+	unsigned long head = (unsigned long)os_atomic_load_long(&ring->head);
+	if (head == tail)
+		return false;
+	*value = ring->values[tail & (METRICS_RING_SIZE - 1)];
+	os_atomic_set_long(&ring->tail, (long)(tail + 1));
+	return true;
+}
+
+#ifdef __cplusplus
+};
+#endif
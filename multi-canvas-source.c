@@ -1,6 +1,8 @@
 
 #include <obs-module.h>
+#include <util/platform.h>
 #include "multi-canvas-source.h"
+#include "metrics-ring.h"
 
 struct multi_canvas_info {
 	obs_source_t *source;
@@ -10,6 +12,7 @@ struct multi_canvas_info {
 	DARRAY(uint32_t) widths;
 	DARRAY(uint32_t) heights;
 	DARRAY(gs_texrender_t *) renders;
+	struct metrics_ring *metrics;
 };
 
 const char *multi_canvas_get_name(void *type_data)
@@ -58,6 +61,7 @@ bool view_get_height(void *data, struct obs_video_info *ovi)
 static void multi_canvas_video_render(void *data, gs_effect_t *effect)
 {
 	struct multi_canvas_info *mc = data;
+	uint64_t start = os_gettime_ns();
 	gs_matrix_push();
 	for (uint32_t i = 0; i < MAX_CHANNELS; i++) {
 		obs_source_t *s = obs_get_output_source(i);
@@ -123,6 +127,7 @@ static void multi_canvas_video_render(void *data, gs_effect_t *effect)
 		gs_matrix_translate3f((float)mc->widths.array[i], 0.0f, 0.0f);
 	}
 	gs_matrix_pop();
+	metrics_ring_push(mc->metrics, os_gettime_ns() - start);
 }
 
 uint32_t multi_canvas_get_width(void *data)
@@ -137,20 +142,26 @@ uint32_t multi_canvas_get_height(void *data)
 	return mc->height;
 }
 
+void multi_canvas_layout(uint32_t base_width, uint32_t base_height, const uint32_t *widths, const uint32_t *heights, size_t count,
+			 uint32_t *width, uint32_t *height)
+{
+	uint32_t w = base_width;
+	uint32_t h = base_height;
+	for (size_t i = 0; i < count; i++) {
+		w += widths[i];
+		if (heights[i] > h)
+			h = heights[i];
+	}
+	*width = w;
+	*height = h;
+}
+
 void multi_canvas_update_size(struct multi_canvas_info *mc)
 {
 	struct obs_video_info ovi;
 	obs_get_video_info(&ovi);
-	uint32_t width = ovi.base_width;
-	uint32_t height = ovi.base_height;
-
-	for (size_t i = 0; i < mc->widths.num; i++) {
-		width += mc->widths.array[i];
-		if (mc->heights.array[i] > height)
-			height = mc->heights.array[i];
-	}
-	mc->width = width;
-	mc->height = height;
+	multi_canvas_layout(ovi.base_width, ovi.base_height, mc->widths.array, mc->heights.array, mc->widths.num, &mc->width,
+			    &mc->height);
 }
 
 void multi_canvas_source_add_view(void *data, obs_view_t *view, uint32_t width, uint32_t height)
@@ -185,6 +196,12 @@ void multi_canvas_source_remove_view(void *data, obs_view_t *view)
 	multi_canvas_update_size(mc);
 }
 
+void multi_canvas_source_set_metrics(void *data, struct metrics_ring *metrics)
+{
+	struct multi_canvas_info *mc = data;
+	mc->metrics = metrics;
+}
+
 struct obs_source_info multi_canvas_source = {
 	.id = "vertical_multi_canvas_source",
 	.type = OBS_SOURCE_TYPE_INPUT,
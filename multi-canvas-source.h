@@ -6,8 +6,13 @@
 extern "C" {
 #endif
 
+struct metrics_ring;
+
 void multi_canvas_source_add_view(void *data, obs_view_t *view, uint32_t width, uint32_t height);
 void multi_canvas_source_remove_view(void *data, obs_view_t *view);
+void multi_canvas_source_set_metrics(void *data, struct metrics_ring *metrics);
+void multi_canvas_layout(uint32_t base_width, uint32_t base_height, const uint32_t *widths, const uint32_t *heights, size_t count,
+			 uint32_t *width, uint32_t *height);
 
 extern struct obs_source_info multi_canvas_source;
 
@@ -146,8 +146,6 @@ void OBSProjector::OBSRender(void *data, uint32_t cx, uint32_t cy)
 	if (!window->ready)
 		return;
 
-	obs_view_t *view = window->canvas->view;
-
 	uint32_t targetCX;
 	uint32_t targetCY;
 	int x, y;
@@ -164,7 +162,7 @@ void OBSProjector::OBSRender(void *data, uint32_t cx, uint32_t cy)
 
 	startRegion(x, y, newCX, newCY, 0.0f, float(targetCX), 0.0f, float(targetCY));
 
-	obs_view_render(view);
+	window->canvas->RenderView();
 
 	endRegion();
 }
@@ -0,0 +1,330 @@
+#include <obs-module.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include "render-cache-source.h"
+#include "metrics-ring.h"
+
+struct render_cache_info {
+	obs_source_t *source;
+	pthread_mutex_t mutex;
+	obs_source_t *target;
+	uint32_t width;
+	uint32_t height;
+	volatile long generation;
+	gs_texrender_t *render;
+	enum gs_color_space space;
+	uint64_t hash;
+	uint64_t frame_time;
+	bool valid;
+	struct metrics_ring *metrics;
+};
+
+/* sources that only change through a settings update or a transform */
+static const char *static_source_ids[] = {"scene",           "group",           "color_source",       "color_source_v2",
+					   "color_source_v3", "image_source",    "text_gdiplus",       "text_gdiplus_v2",
+					   "text_gdiplus_v3", "text_ft2_source", "text_ft2_source_v2", NULL};
+
+struct render_cache_walk {
+	uint64_t hash;
+	bool dynamic;
+};
+
+static inline void hash_bytes(uint64_t *hash, const void *data, size_t size)
+{
+	const uint8_t *p = data;
+	for (size_t i = 0; i < size; i++) {
+		*hash ^= p[i];
+		*hash *= 0x100000001b3ULL;
+	}
+}
+
+static inline void hash_ptr(uint64_t *hash, const void *ptr)
+{
+	hash_bytes(hash, &ptr, sizeof(ptr));
+}
+
+static bool is_static_source_id(const char *id)
+{
+	if (!id)
+		return false;
+	for (const char **s = static_source_ids; *s; s++) {
+		if (strcmp(*s, id) == 0)
+			return true;
+	}
+	return false;
+}
+
+/* static types that can still animate or reload on their own */
+static bool source_changes_itself(obs_source_t *source, const char *id)
+{
+	bool changes = false;
+	if (strcmp(id, "image_source") == 0) {
+		obs_data_t *settings = obs_source_get_settings(source);
+		const char *file = obs_data_get_string(settings, "file");
+		const size_t len = strlen(file);
+		changes = len > 4 && astrcmpi(file + len - 4, ".gif") == 0;
+		obs_data_release(settings);
+	} else if (strncmp(id, "text_gdiplus", 12) == 0) {
+		obs_data_t *settings = obs_source_get_settings(source);
+		changes = obs_data_get_bool(settings, "read_from_file");
+		obs_data_release(settings);
+	} else if (strncmp(id, "text_ft2_source", 15) == 0) {
+		obs_data_t *settings = obs_source_get_settings(source);
+		changes = obs_data_get_bool(settings, "from_file") || obs_data_get_bool(settings, "log_mode");
+		obs_data_release(settings);
+	}
+	return changes;
+}
+
+static void render_cache_walk_filter(obs_source_t *parent, obs_source_t *filter, void *param)
+{
+	UNUSED_PARAMETER(parent);
+	struct render_cache_walk *walk = param;
+	if (obs_source_enabled(filter))
+		walk->dynamic = true;
+}
+
+static bool render_cache_walk_item(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
+{
+	UNUSED_PARAMETER(scene);
+	struct render_cache_walk *walk = param;
+	struct matrix4 transform;
+	struct obs_sceneitem_crop crop;
+	const bool visible = obs_sceneitem_visible(item);
+	const enum obs_blending_type blending = obs_sceneitem_get_blending_mode(item);
+
+	obs_sceneitem_get_draw_transform(item, &transform);
+	obs_sceneitem_get_crop(item, &crop);
+
+	hash_ptr(&walk->hash, item);
+	hash_bytes(&walk->hash, &visible, sizeof(visible));
+	hash_bytes(&walk->hash, &blending, sizeof(blending));
+	hash_bytes(&walk->hash, &transform, sizeof(transform));
+	hash_bytes(&walk->hash, &crop, sizeof(crop));
+	return true;
+}
+
+static void render_cache_walk_source(obs_source_t *parent, obs_source_t *child, void *param)
+{
+	UNUSED_PARAMETER(parent);
+	struct render_cache_walk *walk = param;
+	if (walk->dynamic)
+		return;
+
+	if (obs_source_get_type(child) == OBS_SOURCE_TYPE_TRANSITION) {
+		obs_source_t *b = obs_transition_get_source(child, OBS_TRANSITION_SOURCE_B);
+		if (b || obs_transition_get_time(child) < 1.0f)
+			walk->dynamic = true;
+		obs_source_release(b);
+	} else {
+		const uint32_t flags = obs_source_get_output_flags(child);
+		if ((flags & OBS_SOURCE_VIDEO) == 0)
+			return;
+		const char *id = obs_source_get_id(child);
+		if ((flags & OBS_SOURCE_ASYNC) != 0 || !is_static_source_id(id) || source_changes_itself(child, id)) {
+			walk->dynamic = true;
+			return;
+		}
+	}
+
+	obs_source_enum_filters(child, render_cache_walk_filter, walk);
+
+	const uint32_t size[2] = {obs_source_get_width(child), obs_source_get_height(child)};
+	hash_ptr(&walk->hash, child);
+	hash_bytes(&walk->hash, size, sizeof(size));
+
+	obs_scene_t *scene = obs_scene_from_source(child);
+	if (!scene)
+		scene = obs_group_from_source(child);
+	if (scene)
+		obs_scene_enum_items(scene, render_cache_walk_item, walk);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void render_cache_source_update(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(cd);
+	struct render_cache_info *rc = data;
+	os_atomic_inc_long(&rc->generation);
+}
+
+const char *render_cache_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "vertical_render_cache";
+}
+
+void *render_cache_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	struct render_cache_info *rc = bzalloc(sizeof(struct render_cache_info));
+	rc->source = source;
+	pthread_mutex_init(&rc->mutex, NULL);
+	signal_handler_connect(obs_get_signal_handler(), "source_update", render_cache_source_update, rc);
+	return rc;
+}
+
+void render_cache_destroy(void *data)
+{
+	struct render_cache_info *rc = data;
+	signal_handler_disconnect(obs_get_signal_handler(), "source_update", render_cache_source_update, rc);
+	render_cache_source_set_target(rc, NULL);
+	obs_enter_graphics();
+	gs_texrender_destroy(rc->render);
+	obs_leave_graphics();
+	pthread_mutex_destroy(&rc->mutex);
+	bfree(data);
+}
+
+static void render_cache_draw(struct render_cache_info *rc)
+{
+	gs_texture_t *tex = rc->render ? gs_texrender_get_texture(rc->render) : NULL;
+	if (!tex)
+		return;
+
+	const bool previous = gs_framebuffer_srgb_enabled();
+	gs_enable_framebuffer_srgb(true);
+
+	gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture_srgb(gs_effect_get_param_by_name(effect, "image"), tex);
+
+	// the texture holds premultiplied color
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite(tex, 0, rc->width, rc->height);
+	gs_blend_state_pop();
+
+	gs_enable_framebuffer_srgb(previous);
+}
+
+static void render_cache_video_render(void *data, gs_effect_t *effect)
+{
+	UNUSED_PARAMETER(effect);
+	struct render_cache_info *rc = data;
+	uint64_t start = os_gettime_ns();
+
+	pthread_mutex_lock(&rc->mutex);
+	obs_source_t *target = obs_source_get_ref(rc->target);
+	pthread_mutex_unlock(&rc->mutex);
+	if (!target || !rc->width || !rc->height) {
+		obs_source_release(target);
+		return;
+	}
+
+	const enum gs_color_space space = gs_get_color_space();
+	const enum gs_color_format format = gs_get_format_from_space(space);
+	if (!rc->render || gs_texrender_get_format(rc->render) != format) {
+		gs_texrender_destroy(rc->render);
+		rc->render = gs_texrender_create(format, GS_ZS_NONE);
+		rc->valid = false;
+	}
+
+	struct render_cache_walk walk = {0xcbf29ce484222325ULL, false};
+	const long generation = os_atomic_load_long(&rc->generation);
+	hash_bytes(&walk.hash, &generation, sizeof(generation));
+	hash_bytes(&walk.hash, &rc->width, sizeof(rc->width));
+	hash_bytes(&walk.hash, &rc->height, sizeof(rc->height));
+	render_cache_walk_source(rc->source, target, &walk);
+	if (!walk.dynamic)
+		obs_source_enum_active_tree(target, render_cache_walk_source, &walk);
+
+	bool current = true;
+	if (walk.dynamic || !rc->valid || walk.hash != rc->hash || rc->space != space) {
+		gs_texrender_reset(rc->render);
+		gs_blend_state_push();
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+		rc->valid = false;
+		current = false;
+		if (gs_texrender_begin_with_color_space(rc->render, rc->width, rc->height, space)) {
+			struct vec4 clear_color;
+
+			vec4_zero(&clear_color);
+			gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+			gs_ortho(0.0f, (float)rc->width, 0.0f, (float)rc->height, -100.0f, 100.0f);
+
+			obs_source_video_render(target);
+
+			gs_texrender_end(rc->render);
+			rc->valid = !walk.dynamic;
+			current = true;
+		}
+		gs_blend_state_pop();
+		rc->hash = walk.hash;
+		rc->space = space;
+	}
+	obs_source_release(target);
+	rc->frame_time = current ? obs_get_video_frame_time() : 0;
+
+	render_cache_draw(rc);
+	metrics_ring_push(rc->metrics, os_gettime_ns() - start);
+}
+
+uint32_t render_cache_get_width(void *data)
+{
+	struct render_cache_info *rc = data;
+	return rc->width;
+}
+
+uint32_t render_cache_get_height(void *data)
+{
+	struct render_cache_info *rc = data;
+	return rc->height;
+}
+
+void render_cache_source_set_target(void *data, obs_source_t *target)
+{
+	struct render_cache_info *rc = data;
+	// the view only shows the cache, keep the canvas source showing and active
+	obs_source_t *ref = obs_source_get_ref(target);
+	if (ref) {
+		obs_source_inc_showing(ref);
+		obs_source_inc_active(ref);
+	}
+	pthread_mutex_lock(&rc->mutex);
+	obs_source_t *old = rc->target;
+	rc->target = ref;
+	pthread_mutex_unlock(&rc->mutex);
+	if (old) {
+		obs_source_dec_showing(old);
+		obs_source_dec_active(old);
+		obs_source_release(old);
+	}
+}
+
+void render_cache_source_set_size(void *data, uint32_t width, uint32_t height)
+{
+	struct render_cache_info *rc = data;
+	rc->width = width;
+	rc->height = height;
+}
+
+void render_cache_source_set_metrics(void *data, struct metrics_ring *metrics)
+{
+	struct render_cache_info *rc = data;
+	rc->metrics = metrics;
+}
+
+bool render_cache_source_draw_shared(void *data)
+{
+	struct render_cache_info *rc = data;
+	// only a texture from this frame is known to match the tree
+	if (!rc->frame_time || rc->frame_time != obs_get_video_frame_time() || rc->space != gs_get_color_space())
+		return false;
+	render_cache_draw(rc);
+	return true;
+}
+
+struct obs_source_info render_cache_source = {
+	.id = "vertical_render_cache_source",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CAP_DISABLED | OBS_SOURCE_CUSTOM_DRAW,
+	.get_name = render_cache_get_name,
+	.create = render_cache_create,
+	.destroy = render_cache_destroy,
+	.video_render = render_cache_video_render,
+	.get_width = render_cache_get_width,
+	.get_height = render_cache_get_height,
+};
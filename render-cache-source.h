@@ -0,0 +1,25 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct metrics_ring;
+
+/* Renders the canvas source into a texture and draws that texture again
+ * while nothing in the source tree changed. A frame is rendered when a
+ * source updates its settings, an item changes, a transition runs or the
+ * tree contains a source that can change by itself. */
+void render_cache_source_set_target(void *data, obs_source_t *target);
+void render_cache_source_set_size(void *data, uint32_t width, uint32_t height);
+void render_cache_source_set_metrics(void *data, struct metrics_ring *metrics);
+
+/* Draws the texture rendered for the current video frame without touching
+ * the source tree, returns false when there is none yet and the caller has
+ * to render the view itself. Graphics thread only. */
+bool render_cache_source_draw_shared(void *data);
+
+extern struct obs_source_info render_cache_source;
+
+#ifdef __cplusplus
+};
+#endif
@@ -72,6 +72,7 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *item)
 			if (s)
 				continue;
 			obs_source_set_name(source, name.c_str());
+			CanvasDock::QueueSave();
 		} while (s);
 		obs_source_release(source);
 	});
@@ -288,6 +289,7 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 			if (s)
 				continue;
 			obs_source_set_name(source, name.c_str());
+			CanvasDock::QueueSave();
 		} while (s);
 		obs_source_release(source);
 	});
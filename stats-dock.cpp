@@ -0,0 +1,129 @@
+#include "stats-dock.hpp"
+
+#include "obs-module.h"
+#include "vertical-canvas.hpp"
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include "util/platform.h"
+
+static QString LagText(uint32_t lagged, uint32_t total)
+{
+	double pct = total ? (double)lagged / (double)total * 100.0 : 0.0;
+	return QString::fromUtf8("%1 / %2 (%3%)").arg(lagged).arg(total).arg(QString::number(pct, 'f', 1));
+}
+
+CanvasStatsDock::CanvasStatsDock(CanvasDock *canvas_dock, QWidget *parent) : QFrame(parent), canvasDock(canvas_dock)
+{
+	setMinimumWidth(100);
+	setMinimumHeight(50);
+	setContentsMargins(0, 0, 0, 0);
+
+	auto mainLayout = new QVBoxLayout();
+	mainLayout->setContentsMargins(4, 4, 4, 4);
+	mainLayout->setSpacing(2);
+
+	auto lagLayout = new QFormLayout;
+	lagLayout->setContentsMargins(0, 0, 0, 0);
+	lagLayout->setLabelAlignment(Qt::AlignRight | Qt::AlignVCenter);
+	encoderLag = new QLabel;
+	lagLayout->addRow(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.SkippedFrames")), encoderLag);
+	renderLag = new QLabel;
+	lagLayout->addRow(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.MissedFrames")), renderLag);
+	mainLayout->addLayout(lagLayout);
+
+	outputTable = new QTableWidget(0, 6);
+	outputTable->setHorizontalHeaderLabels({
+		QString::fromUtf8(obs_module_text("Output")),
+		QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.Status")),
+		QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.DroppedFrames")),
+		QString::fromUtf8(obs_module_text("Congestion")),
+		QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.MegabytesSent")),
+		QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.Bitrate")),
+	});
+	outputTable->verticalHeader()->setVisible(false);
+	outputTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+	outputTable->horizontalHeader()->setStretchLastSection(true);
+	outputTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	outputTable->setSelectionMode(QAbstractItemView::NoSelection);
+	mainLayout->addWidget(outputTable, 1);
+
+	auto hl = new QHBoxLayout();
+	hl->addStretch();
+	auto resetButton = new QPushButton(QString::fromUtf8(obs_module_text("ResetMetrics")));
+	connect(resetButton, &QPushButton::clicked, [this] { canvasDock->ResetMetrics(); });
+	hl->addWidget(resetButton);
+	auto exportButton = new QPushButton(QString::fromUtf8(obs_module_text("ExportMetrics")));
+	connect(exportButton, &QPushButton::clicked, [this] { ExportMetrics(); });
+	hl->addWidget(exportButton);
+	mainLayout->addLayout(hl);
+
+	setLayout(mainLayout);
+}
+
+CanvasStatsDock::~CanvasStatsDock() {}
+
+void CanvasStatsDock::Update(const CanvasStats &stats)
+{
+	encoderLag->setText(LagText(stats.encoder_skipped_frames, stats.encoder_total_frames));
+	renderLag->setText(LagText(stats.render_lagged_frames, stats.render_total_frames));
+
+	if (outputTable->rowCount() != (int)stats.outputs.size())
+		outputTable->setRowCount((int)stats.outputs.size());
+
+	auto setCell = [this](int row, int column, const QString &text) {
+		auto item = outputTable->item(row, column);
+		if (!item) {
+			item = new QTableWidgetItem;
+			outputTable->setItem(row, column, item);
+		}
+		if (item->text() != text)
+			item->setText(text);
+	};
+
+	int row = 0;
+	for (const auto &os : stats.outputs) {
+		setCell(row, 0, QString::fromUtf8(os.name.c_str()));
+		const char *status = os.reconnecting ? "Basic.Stats.Status.Reconnecting"
+				     : !os.active     ? "Basic.Stats.Status.Inactive"
+				     : os.type == "stream" ? "Basic.Stats.Status.Live"
+							   : "Basic.Stats.Status.Recording";
+		setCell(row, 1, QString::fromUtf8(obs_frontend_get_locale_string(status)));
+		double dropped = os.total_frames ? (double)os.dropped_frames / (double)os.total_frames * 100.0 : 0.0;
+		setCell(row, 2,
+			QString::fromUtf8("%1 / %2 (%3%)")
+				.arg(os.dropped_frames)
+				.arg(os.total_frames)
+				.arg(QString::number(dropped, 'f', 1)));
+		setCell(row, 3, QString::number(os.congestion * 100.0f, 'f', 1) + "%");
+		setCell(row, 4, QString::number((double)os.total_bytes / (1024.0 * 1024.0), 'f', 1) + " MB");
+		setCell(row, 5, QString::number(os.kbps, 'f', 0) + " kb/s");
+		row++;
+	}
+}
+
+void CanvasStatsDock::ExportMetrics()
+{
+	QString selectedFilter;
+	const QString path = QFileDialog::getSaveFileName(this, QString::fromUtf8(obs_module_text("ExportMetrics")), QString(),
+							  QString::fromUtf8("JSON (*.json);;CSV (*.csv)"), &selectedFilter);
+	if (path.isEmpty())
+		return;
+	const auto file = path.toUtf8();
+	bool success;
+	if (selectedFilter.startsWith("CSV") || path.endsWith(".csv", Qt::CaseInsensitive)) {
+		obs_data_t *d = obs_data_create();
+		canvasDock->GetMetrics(d, true);
+		const char *csv = obs_data_get_string(d, "csv");
+		success = os_quick_write_utf8_file(file.constData(), csv, strlen(csv), false);
+		obs_data_release(d);
+	} else {
+		obs_data_t *d = obs_data_create();
+		canvasDock->GetMetrics(d, false);
+		success = obs_data_save_json_pretty(d, file.constData());
+		obs_data_release(d);
+	}
+	if (!success)
+		blog(LOG_WARNING, "[Vertical Canvas] Failed exporting metrics to %s", file.constData());
+}
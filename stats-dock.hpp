@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QFrame>
+#include <QLabel>
+#include <QTableWidget>
+
+class CanvasDock;
+
+class OutputStats {
+public:
+	const void *output = nullptr;
+	std::string name;
+	std::string type;
+	bool active = false;
+	bool reconnecting = false;
+	int total_frames = 0;
+	int dropped_frames = 0;
+	float congestion = 0.0f;
+	uint64_t total_bytes = 0;
+	double kbps = 0.0;
+	uint64_t sample_time = 0;
+};
+
+class CanvasStats {
+public:
+	uint32_t encoder_total_frames = 0;
+	uint32_t encoder_skipped_frames = 0;
+	uint32_t render_total_frames = 0;
+	uint32_t render_lagged_frames = 0;
+	std::vector<OutputStats> outputs;
+};
+
+class CanvasStatsDock : public QFrame {
+	Q_OBJECT
+	friend class CanvasDock;
+
+private:
+	CanvasDock *canvasDock;
+	QLabel *encoderLag;
+	QLabel *renderLag;
+	QTableWidget *outputTable;
+
+	void Update(const CanvasStats &stats);
+	void ExportMetrics();
+
+public:
+	CanvasStatsDock(CanvasDock *canvas_dock, QWidget *parent = nullptr);
+	~CanvasStatsDock();
+};
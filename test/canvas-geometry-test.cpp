@@ -0,0 +1,244 @@
+#include <obs.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../canvas-geometry.hpp"
+
+#define BOUNDS_TOLERANCE 0.0001f
+#define BORDERLINE_EPSILON 0.001
+
+/* Checks the batched geometry against the scalar code it replaced. The hit
+ * test reference is the per item test FindItemsInBox did before the
+ * extraction, items that sit within float noise of a decision edge are
+ * allowed to differ because both compute that edge differently. */
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                             \
+	do {                                         \
+		if (!(cond)) {                       \
+			fprintf(stderr, __VA_ARGS__); \
+			fputc('\n', stderr);          \
+			failures++;                  \
+		}                                    \
+	} while (false)
+
+static bool CloseFloat(float a, float b, float epsilon = 0.01f)
+{
+	return std::abs(a - b) <= epsilon;
+}
+
+static bool ReferenceFindItemInBox(const matrix4 &transform, const vec2 &startPos, const vec2 &pos)
+{
+	matrix4 invTransform = {};
+	vec3 transformedPos;
+	vec3 pos3;
+	vec3 pos3_;
+
+	vec2 pos_min, pos_max;
+	vec2_min(&pos_min, &startPos, &pos);
+	vec2_max(&pos_max, &startPos, &pos);
+
+	const float x1 = pos_min.x;
+	const float x2 = pos_max.x;
+	const float y1 = pos_min.y;
+	const float y2 = pos_max.y;
+
+	vec3_set(&pos3, pos.x, pos.y, 0.0f);
+
+	matrix4_inv(&invTransform, &transform);
+	vec3_transform(&transformedPos, &pos3, &invTransform);
+	vec3_transform(&pos3_, &transformedPos, &transform);
+
+	if (CloseFloat(pos3.x, pos3_.x) && CloseFloat(pos3.y, pos3_.y) && transformedPos.x >= 0.0f && transformedPos.x <= 1.0f &&
+	    transformedPos.y >= 0.0f && transformedPos.y <= 1.0f)
+		return true;
+
+	if (transform.t.x > x1 && transform.t.x < x2 && transform.t.y > y1 && transform.t.y < y2)
+		return true;
+
+	if (transform.t.x + transform.x.x > x1 && transform.t.x + transform.x.x < x2 && transform.t.y + transform.x.y > y1 &&
+	    transform.t.y + transform.x.y < y2)
+		return true;
+
+	if (transform.t.x + transform.y.x > x1 && transform.t.x + transform.y.x < x2 && transform.t.y + transform.y.y > y1 &&
+	    transform.t.y + transform.y.y < y2)
+		return true;
+
+	if (transform.t.x + transform.x.x + transform.y.x > x1 && transform.t.x + transform.x.x + transform.y.x < x2 &&
+	    transform.t.y + transform.x.y + transform.y.y > y1 && transform.t.y + transform.x.y + transform.y.y < y2)
+		return true;
+
+	if (transform.t.x + 0.5 * (transform.x.x + transform.y.x) > x1 && transform.t.x + 0.5 * (transform.x.x + transform.y.x) < x2 &&
+	    transform.t.y + 0.5 * (transform.x.y + transform.y.y) > y1 && transform.t.y + 0.5 * (transform.x.y + transform.y.y) < y2)
+		return true;
+
+	return IntersectBox(transform, x1, x2, y1, y2);
+}
+
+static bool Near(double a, double b)
+{
+	return std::abs(a - b) < BORDERLINE_EPSILON * std::fmax(1.0, std::abs(b));
+}
+
+/* pos on the item outline or a corner or the center on the box outline */
+static bool Borderline(const matrix4 &t, const vec2 &pos, float x1, float x2, float y1, float y2)
+{
+	const double det = (double)t.x.x * t.y.y - (double)t.y.x * t.x.y;
+	if (std::abs(det) < 1.0)
+		return true;
+	const double dx = (double)pos.x - t.t.x;
+	const double dy = (double)pos.y - t.t.y;
+	const double u = (dx * t.y.y - dy * t.y.x) / det;
+	const double v = (dy * t.x.x - dx * t.x.y) / det;
+	if (u > -BORDERLINE_EPSILON && u < 1.0 + BORDERLINE_EPSILON && v > -BORDERLINE_EPSILON && v < 1.0 + BORDERLINE_EPSILON &&
+	    (Near(u, 0.0) || Near(u, 1.0) || Near(v, 0.0) || Near(v, 1.0)))
+		return true;
+
+	const double px[5] = {t.t.x, t.t.x + t.x.x, t.t.x + t.y.x, t.t.x + t.x.x + t.y.x, t.t.x + 0.5 * (t.x.x + t.y.x)};
+	const double py[5] = {t.t.y, t.t.y + t.x.y, t.t.y + t.y.y, t.t.y + t.x.y + t.y.y, t.t.y + 0.5 * (t.x.y + t.y.y)};
+	for (int i = 0; i < 5; i++) {
+		if (Near(px[i], x1) || Near(px[i], x2) || Near(py[i], y1) || Near(py[i], y2))
+			return true;
+	}
+	return false;
+}
+
+static matrix4 MakeTransform(float x, float y, float cx, float cy, float rot)
+{
+	matrix4 transform;
+	matrix4_identity(&transform);
+	matrix4_scale3f(&transform, &transform, cx, cy, 1.0f);
+	matrix4_rotate_aa4f(&transform, &transform, 0.0f, 0.0f, 1.0f, RAD(rot));
+	matrix4_translate3f(&transform, &transform, x, y, 0.0f);
+	return transform;
+}
+
+static std::vector<matrix4> MakeTransforms(size_t count, std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> pos(-400.0f, 2300.0f);
+	std::uniform_real_distribution<float> size(-800.0f, 800.0f);
+	std::uniform_real_distribution<float> rot(0.0f, 360.0f);
+	std::vector<matrix4> transforms(count);
+	for (size_t i = 0; i < count; i++) {
+		switch (i % 4) {
+		case 0: // axis aligned
+			transforms[i] = MakeTransform(pos(rng), pos(rng), std::abs(size(rng)) + 1.0f, std::abs(size(rng)) + 1.0f, 0.0f);
+			break;
+		case 1: // rotated
+			transforms[i] = MakeTransform(pos(rng), pos(rng), std::abs(size(rng)) + 1.0f, std::abs(size(rng)) + 1.0f, rot(rng));
+			break;
+		default: // flipped on one or both axes and rotated
+			transforms[i] = MakeTransform(pos(rng), pos(rng), size(rng), size(rng), rot(rng));
+			break;
+		}
+	}
+	return transforms;
+}
+
+static void TestTransformedBounds(const std::vector<matrix4> &transforms, const char *name)
+{
+	const size_t count = transforms.size();
+	std::vector<vec2> tl(count), br(count);
+	GetTransformedBounds(transforms.data(), count, tl.data(), br.data());
+	for (size_t i = 0; i < count; i++) {
+		vec3 tl3, br3;
+		GetTransformedBounds(transforms[i], tl3, br3);
+		const float extent = std::fmax(std::fmax(std::abs(tl3.x), std::abs(tl3.y)), std::fmax(std::abs(br3.x), std::abs(br3.y)));
+		const float tolerance = BOUNDS_TOLERANCE * std::fmax(1.0f, extent);
+		CHECK(CloseFloat(tl[i].x, tl3.x, tolerance) && CloseFloat(tl[i].y, tl3.y, tolerance) &&
+			      CloseFloat(br[i].x, br3.x, tolerance) && CloseFloat(br[i].y, br3.y, tolerance),
+		      "%s: bounds of item %zu are %g,%g %g,%g, scalar %g,%g %g,%g", name, i, tl[i].x, tl[i].y, br[i].x, br[i].y,
+		      tl3.x, tl3.y, br3.x, br3.y);
+	}
+}
+
+static void TestBoxHitTest(const std::vector<matrix4> &transforms, const vec2 &startPos, const vec2 &pos, const char *name,
+			   const uint8_t *expected_hits = nullptr)
+{
+	const size_t count = transforms.size();
+	vec2 pos_min, pos_max;
+	vec2_min(&pos_min, &startPos, &pos);
+	vec2_max(&pos_max, &startPos, &pos);
+
+	std::vector<uint8_t> hits(count, 2);
+	const size_t found = BoxHitTest(transforms.data(), count, pos, pos_min.x, pos_max.x, pos_min.y, pos_max.y, hits.data());
+
+	size_t counted = 0;
+	for (size_t i = 0; i < count; i++) {
+		CHECK(hits[i] <= 1, "%s: item %zu has no result", name, i);
+		counted += hits[i] ? 1 : 0;
+		const bool expected = ReferenceFindItemInBox(transforms[i], startPos, pos);
+		if (expected_hits) {
+			CHECK(hits[i] == expected_hits[i] && expected == (expected_hits[i] == 1), "%s: item %zu hit %d, reference %d, expected %d",
+			      name, i, hits[i], expected, expected_hits[i]);
+		} else if (expected != (hits[i] == 1) &&
+		    !Borderline(transforms[i], pos, pos_min.x, pos_max.x, pos_min.y, pos_max.y)) {
+			CHECK(false, "%s: item %zu hit %d, reference %d", name, i, hits[i], expected);
+		}
+	}
+	CHECK(found == counted, "%s: returned %zu hits, marked %zu", name, found, counted);
+}
+
+static void TestFixedCases()
+{
+	vec2 startPos, pos;
+	vec2_set(&startPos, 400.0f, 300.0f);
+	vec2_set(&pos, 1200.0f, 700.0f);
+
+	std::vector<matrix4> transforms;
+	// inside the box, around the box, a rotated bar that only crosses the box corner with an edge, outside
+	transforms.push_back(MakeTransform(500.0f, 400.0f, 100.0f, 100.0f, 0.0f));
+	transforms.push_back(MakeTransform(0.0f, 0.0f, 1920.0f, 1080.0f, 0.0f));
+	transforms.push_back(MakeTransform(300.0f, 380.0f, 200.0f, 20.0f, -45.0f));
+	transforms.push_back(MakeTransform(1500.0f, 900.0f, 100.0f, 100.0f, 0.0f));
+	// rotated next to the box corner without touching it
+	transforms.push_back(MakeTransform(380.0f, 200.0f, 60.0f, 60.0f, 45.0f));
+	// flipped on x, on y and on both
+	transforms.push_back(MakeTransform(600.0f, 500.0f, -100.0f, 100.0f, 0.0f));
+	transforms.push_back(MakeTransform(600.0f, 500.0f, 100.0f, -100.0f, 0.0f));
+	transforms.push_back(MakeTransform(1800.0f, 1000.0f, -100.0f, -100.0f, 30.0f));
+	// degenerate: zero width, zero height and zero size, away from pos
+	transforms.push_back(MakeTransform(800.0f, 200.0f, 0.0f, 300.0f, 0.0f));
+	transforms.push_back(MakeTransform(200.0f, 500.0f, 600.0f, 0.0f, 0.0f));
+	transforms.push_back(MakeTransform(800.0f, 500.0f, 0.0f, 0.0f, 0.0f));
+	transforms.push_back(MakeTransform(100.0f, 100.0f, 0.0f, 0.0f, 0.0f));
+	const uint8_t expected[] = {1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1, 0};
+
+	TestTransformedBounds(transforms, "fixed");
+	TestBoxHitTest(transforms, startPos, pos, "fixed", expected);
+
+	// the box dragged the other way round
+	TestBoxHitTest(transforms, pos, startPos, "fixed reversed");
+
+	// a box inside a large item only hits through pos
+	vec2_set(&startPos, 900.0f, 500.0f);
+	vec2_set(&pos, 950.0f, 550.0f);
+	TestBoxHitTest(transforms, startPos, pos, "fixed inside");
+}
+
+int main()
+{
+	TestFixedCases();
+
+	std::mt19937 rng(42);
+	vec2 startPos, pos;
+	vec2_set(&startPos, 400.0f, 300.0f);
+	vec2_set(&pos, 1200.0f, 700.0f);
+	// partial registers, a few full ones and enough items for the worker threads
+	const size_t counts[] = {1, 3, 4, 7, 100, 1000, BOX_HIT_TEST_PARALLEL_MIN * 2 + 3};
+	for (size_t count : counts) {
+		const std::vector<matrix4> transforms = MakeTransforms(count, rng);
+		char name[64];
+		snprintf(name, sizeof(name), "random %zu", count);
+		TestTransformedBounds(transforms, name);
+		TestBoxHitTest(transforms, startPos, pos, name);
+	}
+
+	if (failures)
+		fprintf(stderr, "%d checks failed\n", failures);
+	return failures ? 1 : 0;
+}
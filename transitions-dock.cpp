@@ -47,6 +47,7 @@ CanvasTransitionsDock::CanvasTransitionsDock(CanvasDock *canvas_dock, QWidget *p
 	addButton->setFlat(false);
 
 	connect(addButton, &QPushButton::clicked, [this] {
+		canvasDock->LoadDeferredTransitions();
 		auto menu = QMenu(this);
 		auto subMenu = menu.addMenu(QString::fromUtf8(obs_module_text("CopyFromMain")));
 		struct obs_frontend_source_list transitions = {};
@@ -68,7 +69,8 @@ CanvasTransitionsDock::CanvasTransitionsDock(CanvasDock *canvas_dock, QWidget *p
 				OBSDataAutoRelease d = obs_save_source(tr);
 				OBSSourceAutoRelease t = obs_load_private_source(d);
 				if (t) {
-					canvasDock->transitions.emplace_back(t);
+					canvasDock->AddTransition(t);
+					CanvasDock::QueueSave();
 					auto n = QString::fromUtf8(obs_source_get_name(t));
 					transition->addItem(n);
 					transition->setCurrentText(n);
@@ -110,7 +112,8 @@ CanvasTransitionsDock::CanvasTransitionsDock(CanvasDock *canvas_dock, QWidget *p
 						obs_source_set_name(t, name.c_str());
 						break;
 					}
-					canvasDock->transitions.emplace_back(t);
+					canvasDock->AddTransition(t);
+					CanvasDock::QueueSave();
 					auto n = QString::fromUtf8(obs_source_get_name(t));
 					transition->addItem(n);
 					transition->setCurrentText(n);
@@ -142,13 +145,11 @@ CanvasTransitionsDock::CanvasTransitionsDock(CanvasDock *canvas_dock, QWidget *p
 			return;
 
 		auto n = transition->currentText().toUtf8();
-		for (auto it = canvasDock->transitions.begin(); it != canvasDock->transitions.end(); ++it) {
-			if (strcmp(n.constData(), obs_source_get_name(it->Get())) == 0) {
-				if (!obs_is_source_configurable(obs_source_get_unversioned_id(it->Get())))
-					return;
-				canvasDock->transitions.erase(it);
-				break;
-			}
+		obs_source_t *t = canvasDock->GetTransition(n.constData());
+		if (t) {
+			if (!obs_is_source_configurable(obs_source_get_unversioned_id(t)))
+				return;
+			canvasDock->RemoveTransition(t);
 		}
 		transition->removeItem(transition->currentIndex());
 		if (transition->currentIndex() < 0)
@@ -192,7 +193,7 @@ CanvasTransitionsDock::CanvasTransitionsDock(CanvasDock *canvas_dock, QWidget *p
 					continue;
 
 				transition->setItemText(transition->currentIndex(), QString::fromUtf8(name.c_str()));
-				obs_source_set_name(t, name.c_str());
+				canvasDock->RenameTransition(t, name.c_str());
 				break;
 			}
 		});
@@ -1,11 +1,16 @@
 #include "vertical-canvas.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <list>
+#include <unordered_map>
 
 #include "version.h"
 
 #include <obs-module.h>
 #include <obs-frontend-api.h>
+#include <QCoreApplication>
 #include <QDesktopServices>
 
 #include <QMainWindow>
@@ -16,19 +21,26 @@
 #include <QListWidget>
 #include <QMenu>
 #include <QMessageBox>
+#include <QThread>
+#include <QUuid>
 #include <QTimer>
 #include <QToolBar>
 #include <QWidgetAction>
 
 #include "scenes-dock.hpp"
+#include "config-cache.hpp"
 #include "config-dialog.hpp"
+#include "config-writer.hpp"
 #include "display-helpers.hpp"
+#include "encoder-resolver.hpp"
+#include "label-atlas.hpp"
 #include "name-dialog.hpp"
 #include "obs-websocket-api.h"
 #include "sources-dock.hpp"
 #include "transitions-dock.hpp"
 #include "audio-wrapper-source.h"
 #include "multi-canvas-source.h"
+#include "render-cache-source.h"
 #include "media-io/video-frame.h"
 #include "util/config-file.h"
 #include "util/dstr.h"
@@ -49,6 +61,9 @@ OBS_MODULE_USE_DEFAULT_LOCALE("vertical-canvas", "en-US")
 #define SPACER_LABEL_MARGIN 6.0f
 
 inline std::list<CanvasDock *> canvas_docks;
+inline std::unordered_map<std::string, CanvasDock *> canvas_index;
+static std::unique_ptr<ConfigWriter> config_writer;
+static bool save_queued = false;
 
 void clear_canvas_docks()
 {
@@ -59,6 +74,7 @@ void clear_canvas_docks()
 		it->deleteLater();
 	}
 	canvas_docks.clear();
+	canvas_index.clear();
 }
 
 static void ensure_directory(char *path)
@@ -86,10 +102,20 @@ static void save_canvas()
 {
 	if (canvas_docks.empty())
 		return;
-	char *path = obs_module_config_path("config.json");
-	if (!path)
-		return;
-	ensure_directory(path);
+	if (!config_writer) {
+		char *path = obs_module_config_path("config.json");
+		char *cache_path = obs_module_config_path("config.bin");
+		if (!path || !cache_path) {
+			bfree(path);
+			bfree(cache_path);
+			return;
+		}
+		ensure_directory(path);
+		config_writer = std::make_unique<ConfigWriter>(path, cache_path);
+		bfree(path);
+		bfree(cache_path);
+	}
+	// the snapshot is taken here on the UI thread, serializing and writing happen on the writer thread
 	obs_data_t *config = obs_data_create();
 	const auto canvas = obs_data_array_create();
 	for (const auto &it : canvas_docks) {
@@ -99,13 +125,21 @@ static void save_canvas()
 	}
 	obs_data_set_array(config, "canvas", canvas);
 	obs_data_array_release(canvas);
-	if (obs_data_save_json_safe(config, path, "tmp", "bak")) {
-		blog(LOG_INFO, "[Vertical Canvas] Saved settings");
-	} else {
-		blog(LOG_ERROR, "[Vertical Canvas] Failed saving settings");
-	}
+	obs_data_set_int(config, "backtrack_budget_mb", CanvasDock::GetBacktrackBudget());
+	config_writer->Queue(config);
 	obs_data_release(config);
-	bfree(path);
+}
+
+void CanvasDock::QueueSave()
+{
+	// changes made in one event loop pass are saved once
+	if (save_queued)
+		return;
+	save_queued = true;
+	QTimer::singleShot(0, static_cast<QMainWindow *>(obs_frontend_get_main_window()), [] {
+		save_queued = false;
+		save_canvas();
+	});
 }
 
 void transition_start(void *, calldata_t *)
@@ -120,6 +154,8 @@ void frontend_event(obs_frontend_event event, void *private_data)
 	UNUSED_PARAMETER(private_data);
 	if (event == OBS_FRONTEND_EVENT_EXIT || event == OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN) {
 		save_canvas();
+		if (config_writer)
+			config_writer->Flush();
 		clear_canvas_docks();
 	} else if (event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP) {
 		for (const auto &it : canvas_docks) {
@@ -197,6 +233,7 @@ void frontend_event(obs_frontend_event event, void *private_data)
 					   [it] { QMetaObject::invokeMethod(it, "MainVirtualCamStop", Qt::QueuedConnection); });
 		}
 	} else if (event == OBS_FRONTEND_EVENT_PROFILE_CHANGED) {
+		EncoderResolver::Invalidate();
 		for (const auto &it : canvas_docks) {
 			QMetaObject::invokeMethod(it, "ProfileChanged", Qt::QueuedConnection);
 		}
@@ -204,6 +241,9 @@ void frontend_event(obs_frontend_event event, void *private_data)
 }
 
 obs_websocket_vendor vendor = nullptr;
+// shared by all websocket clients, vendor events can not be filtered per client
+static std::atomic<uint32_t> vendor_event_mask{VENDOR_EVENT_DEFAULT};
+static std::atomic<uint64_t> vendor_stats_interval_ns{1000000000ULL};
 
 void vendor_request_version(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
@@ -212,8 +252,27 @@ void vendor_request_version(obs_data_t *request_data, obs_data_t *response_data,
 	obs_data_set_bool(response_data, "success", true);
 }
 
-void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_data, void *)
+// canvas_id addresses a canvas directly, without it the first canvas matching width and height is used
+static CanvasDock *find_canvas(obs_data_t *request_data)
+{
+	const char *canvas_id = obs_data_get_string(request_data, "canvas_id");
+	if (canvas_id && strlen(canvas_id)) {
+		const auto it = canvas_index.find(canvas_id);
+		return it == canvas_index.end() ? nullptr : it->second;
+	}
+	const auto width = obs_data_get_int(request_data, "width");
+	const auto height = obs_data_get_int(request_data, "height");
+	for (const auto &it : canvas_docks) {
+		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
+			continue;
+		return it;
+	}
+	return nullptr;
+}
+
+void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_data, void *p)
 {
+	const char *method = static_cast<char *>(p);
 	const char *scene_name = obs_data_get_string(request_data, "scene");
 	if (!scene_name || !strlen(scene_name)) {
 		obs_data_set_string(response_data, "error", "'scene' not set");
@@ -244,10 +303,32 @@ void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_
 	const auto width = obs_data_get_int(settings, "cx");
 	const auto height = obs_data_get_int(settings, "cy");
 	obs_data_release(settings);
+	// with prewarm_ms the scene is marked showing first and switched to after the delay
+	const long long prewarm_ms = obs_data_get_int(request_data, "prewarm_ms");
+	const int delay_ms = (int)std::clamp(prewarm_ms, 0LL, (long long)SCENE_PREWARM_MAX_MS);
+	const QString name = QString::fromUtf8(scene_name);
+	auto dispatch = [&](CanvasDock *it) {
+		if (strcmp(method, "SwitchScene") == 0 && delay_ms > 0)
+			QMetaObject::invokeMethod(it, "QueueSwitchScene", Q_ARG(QString, name), Q_ARG(int, delay_ms));
+		else
+			QMetaObject::invokeMethod(it, method, Q_ARG(QString, name));
+	};
+	const char *canvas_id = obs_data_get_string(request_data, "canvas_id");
+	if (canvas_id && strlen(canvas_id)) {
+		const auto it = find_canvas(request_data);
+		if (!it || it->GetCanvasWidth() != width || it->GetCanvasHeight() != height) {
+			obs_data_set_string(response_data, "error", "'scene' not in canvas");
+			obs_data_set_bool(response_data, "success", false);
+			return;
+		}
+		dispatch(it);
+		obs_data_set_bool(response_data, "success", true);
+		return;
+	}
 	for (const auto &it : canvas_docks) {
 		if (it->GetCanvasWidth() != width || it->GetCanvasHeight() != height)
 			continue;
-		QMetaObject::invokeMethod(it, "SwitchScene", Q_ARG(QString, QString::fromUtf8(scene_name)));
+		dispatch(it);
 	}
 
 	obs_data_set_bool(response_data, "success", true);
@@ -255,98 +336,143 @@ void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_
 
 void vendor_request_current_scene(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
-		auto scene = obs_scene_get_source(it->GetCurrentScene());
-		if (scene) {
-			obs_data_set_string(response_data, "scene", obs_source_get_name(scene));
-		} else {
-			obs_data_set_string(response_data, "scene", "");
-		}
-		obs_data_set_bool(response_data, "success", true);
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
-	obs_data_set_bool(response_data, "success", false);
+	auto scene = obs_scene_get_source(it->GetCurrentScene());
+	if (scene) {
+		obs_data_set_string(response_data, "scene", obs_source_get_name(scene));
+	} else {
+		obs_data_set_string(response_data, "scene", "");
+	}
+	obs_data_set_string(response_data, "canvas_id", it->GetCanvasId().c_str());
+	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_get_scenes(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const char *canvas_id = obs_data_get_string(request_data, "canvas_id");
+	const bool by_id = canvas_id && strlen(canvas_id);
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
+	const auto target = by_id ? find_canvas(request_data) : nullptr;
 	auto sa = obs_data_array_create();
 	for (const auto &it : canvas_docks) {
+		if (by_id && it != target)
+			continue;
 		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
 			continue;
 		auto scenes = it->GetScenes();
 		for (auto &scene : scenes) {
 			auto s = obs_data_create();
 			obs_data_set_string(s, "name", scene.toUtf8().constData());
+			obs_data_set_string(s, "canvas_id", it->GetCanvasId().c_str());
 			obs_data_array_push_back(sa, s);
 			obs_data_release(s);
 		}
 	}
 	obs_data_set_array(response_data, "scenes", sa);
 	obs_data_array_release(sa);
+	obs_data_set_bool(response_data, "success", !by_id || target);
+}
+
+void vendor_request_get_canvases(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	UNUSED_PARAMETER(request_data);
+	auto ca = obs_data_array_create();
+	for (const auto &it : canvas_docks) {
+		auto c = obs_data_create();
+		obs_data_set_string(c, "canvas_id", it->GetCanvasId().c_str());
+		obs_data_set_int(c, "width", it->GetCanvasWidth());
+		obs_data_set_int(c, "height", it->GetCanvasHeight());
+		obs_data_array_push_back(ca, c);
+		obs_data_release(c);
+	}
+	obs_data_set_array(response_data, "canvases", ca);
+	obs_data_array_release(ca);
 	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_status(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
-		obs_data_set_bool(response_data, "streaming", it->StreamingActive());
-		obs_data_set_bool(response_data, "recording", it->RecordingActive());
-		obs_data_set_bool(response_data, "backtrack", it->BacktrackActive());
-		obs_data_set_bool(response_data, "virtual_camera", it->VirtualCameraActive());
-		obs_data_set_bool(response_data, "success", true);
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
+	obs_data_set_string(response_data, "canvas_id", it->GetCanvasId().c_str());
+	obs_data_set_bool(response_data, "streaming", it->StreamingActive());
+	obs_data_set_bool(response_data, "recording", it->RecordingActive());
+	obs_data_set_bool(response_data, "backtrack", it->BacktrackActive());
+	obs_data_set_bool(response_data, "virtual_camera", it->VirtualCameraActive());
+	obs_data_set_bool(response_data, "success", true);
+}
+
+void vendor_request_get_stats(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
+	it->GetStats(response_data);
+	obs_data_set_bool(response_data, "success", true);
+}
+
+void vendor_request_get_metrics(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const char *format = obs_data_get_string(request_data, "format");
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
+	it->GetMetrics(response_data, format && strcmp(format, "csv") == 0);
+	obs_data_set_bool(response_data, "success", true);
+}
+
+void vendor_request_reset_metrics(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
-	obs_data_set_bool(response_data, "success", false);
+	it->ResetMetrics();
+	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_invoke(obs_data_t *request_data, obs_data_t *response_data, void *p)
 {
 	const char *method = static_cast<char *>(p);
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
-		QMetaObject::invokeMethod(it, method);
-		obs_data_set_bool(response_data, "success", true);
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
-	obs_data_set_bool(response_data, "success", false);
+	QMetaObject::invokeMethod(it, method);
+	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_save_replay(obs_data_t *request_data, obs_data_t *response_data, void *p)
 {
 	UNUSED_PARAMETER(p);
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
-		QMetaObject::invokeMethod(it, "ReplayButtonClicked",
-					  Q_ARG(QString, QString::fromUtf8(obs_data_get_string(request_data, "filename"))));
-		obs_data_set_bool(response_data, "success", true);
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
-	obs_data_set_bool(response_data, "success", false);
+	QMetaObject::invokeMethod(it, "ReplayButtonClicked",
+				  Q_ARG(QString, QString::fromUtf8(obs_data_get_string(request_data, "filename"))));
+	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_update_stream_key(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
 	// Parse request_data to get the new stream_key
 	const char *new_stream_key = obs_data_get_string(request_data, "stream_key");
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
 
 	if (!new_stream_key || !strlen(new_stream_key)) {
 		obs_data_set_string(response_data, "error", "'stream_key' not set");
@@ -354,27 +480,23 @@ void vendor_request_update_stream_key(obs_data_t *request_data, obs_data_t *resp
 		return;
 	}
 
-	// Loop through each CanvasDock to find the right one
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
-
-		// Update stream_key using the UpdateStreamKey method of CanvasDock
-		QMetaObject::invokeMethod(it, "updateStreamKey", Q_ARG(QString, QString::fromUtf8(new_stream_key)),
-					  Q_ARG(int, obs_data_get_int(request_data, "index")));
-
-		obs_data_set_bool(response_data, "success", true);
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
-	obs_data_set_bool(response_data, "success", false);
+
+	// Update stream_key using the UpdateStreamKey method of CanvasDock
+	QMetaObject::invokeMethod(it, "updateStreamKey", Q_ARG(QString, QString::fromUtf8(new_stream_key)),
+				  Q_ARG(int, obs_data_get_int(request_data, "index")));
+
+	obs_data_set_bool(response_data, "success", true);
 }
 
 void vendor_request_update_stream_server(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
 	// Parse request_data to get the new stream_server
 	const char *new_stream_server = obs_data_get_string(request_data, "stream_server");
-	const auto width = obs_data_get_int(request_data, "width");
-	const auto height = obs_data_get_int(request_data, "height");
 
 	if (!new_stream_server || !strlen(new_stream_server)) {
 		obs_data_set_string(response_data, "error", "'stream_server' not set");
@@ -382,20 +504,172 @@ void vendor_request_update_stream_server(obs_data_t *request_data, obs_data_t *r
 		return;
 	}
 
-	// Loop through each CanvasDock to find the right one
-	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height))
-			continue;
+	const auto it = find_canvas(request_data);
+	if (!it) {
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
 
-		// Update stream_server using the UpdateStreamServer method of CanvasDock
-		QMetaObject::invokeMethod(it, "updateStreamServer", Q_ARG(QString, QString::fromUtf8(new_stream_server)),
-					  Q_ARG(int, obs_data_get_int(request_data, "index")));
+	// Update stream_server using the UpdateStreamServer method of CanvasDock
+	QMetaObject::invokeMethod(it, "updateStreamServer", Q_ARG(QString, QString::fromUtf8(new_stream_server)),
+				  Q_ARG(int, obs_data_get_int(request_data, "index")));
 
-		obs_data_set_bool(response_data, "success", true);
+	obs_data_set_bool(response_data, "success", true);
+}
+
+static void set_event_subscription_response(obs_data_t *response_data)
+{
+	obs_data_set_int(response_data, "mask", vendor_event_mask);
+	obs_data_set_int(response_data, "stats_interval_ms", (long long)(vendor_stats_interval_ns / 1000000ULL));
+	auto categories = obs_data_create();
+	obs_data_set_int(categories, "streaming", VENDOR_EVENT_STREAMING);
+	obs_data_set_int(categories, "recording", VENDOR_EVENT_RECORDING);
+	obs_data_set_int(categories, "backtrack", VENDOR_EVENT_BACKTRACK);
+	obs_data_set_int(categories, "virtual_camera", VENDOR_EVENT_VIRTUAL_CAMERA);
+	obs_data_set_int(categories, "scene", VENDOR_EVENT_SCENE);
+	obs_data_set_int(categories, "stats", VENDOR_EVENT_STATS);
+	obs_data_set_obj(response_data, "categories", categories);
+	obs_data_release(categories);
+	obs_data_set_bool(response_data, "success", true);
+}
+
+void vendor_request_get_event_subscriptions(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	UNUSED_PARAMETER(request_data);
+	set_event_subscription_response(response_data);
+}
+
+void vendor_request_set_event_subscriptions(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	if (obs_data_has_user_value(request_data, "mask"))
+		vendor_event_mask = (uint32_t)obs_data_get_int(request_data, "mask") & VENDOR_EVENT_ALL;
+	if (obs_data_has_user_value(request_data, "stats_interval_ms")) {
+		// stats are sampled once a second, a shorter interval would repeat the same values
+		const long long interval = std::max(obs_data_get_int(request_data, "stats_interval_ms"), 1000LL);
+		vendor_stats_interval_ns = (uint64_t)interval * 1000000ULL;
+	}
+	set_event_subscription_response(response_data);
+}
+
+void vendor_request_batch(obs_data_t *request_data, obs_data_t *response_data, void *);
+
+struct vendor_request {
+	const char *type;
+	obs_websocket_request_callback_function callback;
+	void *param;
+};
+
+static const vendor_request vendor_requests[] = {
+	{"version", vendor_request_version, nullptr},
+	{"switch_scene", vendor_request_switch_scene, (void *)"SwitchScene"},
+	{"prewarm_scene", vendor_request_switch_scene, (void *)"PrewarmScene"},
+	{"current_scene", vendor_request_current_scene, nullptr},
+	{"get_scenes", vendor_request_get_scenes, nullptr},
+	{"get_canvases", vendor_request_get_canvases, nullptr},
+	{"status", vendor_request_status, nullptr},
+	{"get_stats", vendor_request_get_stats, nullptr},
+	{"get_metrics", vendor_request_get_metrics, nullptr},
+	{"reset_metrics", vendor_request_reset_metrics, nullptr},
+	{"start_streaming", vendor_request_invoke, (void *)"StartStream"},
+	{"stop_streaming", vendor_request_invoke, (void *)"StopStream"},
+	{"toggle_streaming", vendor_request_invoke, (void *)"StreamButtonClicked"},
+	{"start_recording", vendor_request_invoke, (void *)"StartRecord"},
+	{"stop_recording", vendor_request_invoke, (void *)"StopRecord"},
+	{"toggle_recording", vendor_request_invoke, (void *)"RecordButtonClicked"},
+	{"start_backtrack", vendor_request_invoke, (void *)"StartReplayBuffer"},
+	{"stop_backtrack", vendor_request_invoke, (void *)"StopReplayBuffer"},
+	{"save_backtrack", vendor_request_save_replay, nullptr},
+	{"start_virtual_camera", vendor_request_invoke, (void *)"StartVirtualCam"},
+	{"stop_virtual_camera", vendor_request_invoke, (void *)"StopVirtualCam"},
+	{"update_stream_key", vendor_request_update_stream_key, nullptr},
+	{"update_stream_server", vendor_request_update_stream_server, nullptr},
+	{"get_event_subscriptions", vendor_request_get_event_subscriptions, nullptr},
+	{"set_event_subscriptions", vendor_request_set_event_subscriptions, nullptr},
+	{"batch", vendor_request_batch, nullptr},
+};
+
+static const vendor_request *find_vendor_request(const char *type)
+{
+	if (!type)
+		return nullptr;
+	for (const auto &request : vendor_requests) {
+		if (strcmp(request.type, type) == 0)
+			return &request;
+	}
+	return nullptr;
+}
+
+static void run_on_ui_thread(const std::function<void()> &f)
+{
+	const auto app = QCoreApplication::instance();
+	if (!app || QThread::currentThread() == app->thread()) {
+		f();
 		return;
 	}
+	QMetaObject::invokeMethod(app, [&f] { f(); }, Qt::BlockingQueuedConnection);
+}
+
+#define BATCH_MAX_SLEEP_MS 50000
 
-	obs_data_set_bool(response_data, "success", false);
+void vendor_request_batch(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	obs_data_array_t *requests = obs_data_get_array(request_data, "requests");
+	const size_t count = obs_data_array_count(requests);
+	if (!count) {
+		obs_data_array_release(requests);
+		obs_data_set_string(response_data, "error", "'requests' not set");
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
+	const bool halt_on_failure = obs_data_get_bool(request_data, "halt_on_failure");
+	obs_data_array_t *results = obs_data_array_create();
+	bool success = true;
+	bool halted = false;
+	size_t idx = 0;
+	while (idx < count && !halted) {
+		long long sleep_ms = 0;
+		// requests up to the next sleep run in one pass on the UI thread, where the
+		// dock methods they invoke are called directly and in order
+		run_on_ui_thread([&] {
+			while (idx < count && !sleep_ms && !halted) {
+				obs_data_t *item = obs_data_array_item(requests, idx++);
+				const char *type = obs_data_get_string(item, "request_type");
+				obs_data_t *item_response = obs_data_create();
+				const auto request = find_vendor_request(type);
+				if (!request || request->callback == vendor_request_batch) {
+					obs_data_set_string(item_response, "error", "'request_type' not supported");
+					obs_data_set_bool(item_response, "success", false);
+				} else {
+					obs_data_t *data = obs_data_get_obj(item, "request_data");
+					if (!data)
+						data = obs_data_create();
+					request->callback(data, item_response, request->param);
+					obs_data_release(data);
+				}
+				const bool item_success = obs_data_get_bool(item_response, "success");
+				obs_data_t *result = obs_data_create();
+				obs_data_set_string(result, "request_type", type);
+				obs_data_set_bool(result, "success", item_success);
+				obs_data_set_obj(result, "response_data", item_response);
+				obs_data_array_push_back(results, result);
+				obs_data_release(result);
+				obs_data_release(item_response);
+				sleep_ms = obs_data_get_int(item, "sleep_ms");
+				obs_data_release(item);
+				if (!item_success) {
+					success = false;
+					halted = halt_on_failure;
+				}
+			}
+		});
+		if (sleep_ms > 0 && idx < count && !halted)
+			os_sleep_ms((uint32_t)std::min(sleep_ms, (long long)BATCH_MAX_SLEEP_MS));
+	}
+	obs_data_array_release(requests);
+	obs_data_set_array(response_data, "results", results);
+	obs_data_array_release(results);
+	obs_data_set_bool(response_data, "halted", halted);
+	obs_data_set_bool(response_data, "success", success);
 }
 
 update_info_t *verison_update_info = nullptr;
@@ -441,23 +715,36 @@ bool obs_module_load(void)
 
 	obs_register_source(&audio_wrapper_source);
 	obs_register_source(&multi_canvas_source);
+	obs_register_source(&render_cache_source);
 
 	return true;
 }
 
 void obs_module_post_load(void)
 {
+	const uint64_t load_start = os_gettime_ns();
 	const auto path = obs_module_config_path("config.json");
-	obs_data_t *config = obs_data_create_from_json_file_safe(path, "bak");
-	bfree(path);
-	if (!config) {
-		config = obs_data_create();
-		blog(LOG_WARNING, "[Vertical Canvas] No configuration file loaded");
+	const auto cache_path = obs_module_config_path("config.bin");
+	// the binary cache is only used while it matches config.json, otherwise the json is parsed
+	obs_data_t *config = ConfigCache::Load(path, cache_path);
+	if (config) {
+		blog(LOG_INFO, "[Vertical Canvas] Loaded configuration cache in %.3f ms",
+		     (double)(os_gettime_ns() - load_start) / 1000000.0);
 	} else {
-		blog(LOG_INFO, "[Vertical Canvas] Loaded configuration file");
+		config = obs_data_create_from_json_file_safe(path, "bak");
+		if (!config) {
+			config = obs_data_create();
+			blog(LOG_WARNING, "[Vertical Canvas] No configuration file loaded");
+		} else {
+			blog(LOG_INFO, "[Vertical Canvas] Loaded configuration file in %.3f ms",
+			     (double)(os_gettime_ns() - load_start) / 1000000.0);
+		}
 	}
+	bfree(path);
+	bfree(cache_path);
 
 	const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
+	CanvasDock::SetBacktrackBudget((uint32_t)obs_data_get_int(config, "backtrack_budget_mb"));
 	auto canvas = obs_data_get_array(config, "canvas");
 	obs_data_release(config);
 	if (!canvas) {
@@ -487,6 +774,7 @@ void obs_module_post_load(void)
 		blog(LOG_INFO, "[Vertical Canvas] New Canvas created");
 		return;
 	}
+	const uint64_t create_start = os_gettime_ns();
 	for (size_t i = 0; i < count; i++) {
 		const auto item = obs_data_array_item(canvas, i);
 		const auto canvasDock = new CanvasDock(item, main_window);
@@ -509,29 +797,15 @@ void obs_module_post_load(void)
 		canvas_docks.push_back(canvasDock);
 	}
 	obs_data_array_release(canvas);
+	blog(LOG_INFO, "[Vertical Canvas] Created %d canvas in %.3f ms", (int)count,
+	     (double)(os_gettime_ns() - create_start) / 1000000.0);
 
 	if (!vendor)
 		vendor = obs_websocket_register_vendor("aitum-vertical-canvas");
 	if (!vendor)
 		return;
-	obs_websocket_vendor_register_request(vendor, "version", vendor_request_version, nullptr);
-	obs_websocket_vendor_register_request(vendor, "switch_scene", vendor_request_switch_scene, nullptr);
-	obs_websocket_vendor_register_request(vendor, "current_scene", vendor_request_current_scene, nullptr);
-	obs_websocket_vendor_register_request(vendor, "get_scenes", vendor_request_get_scenes, nullptr);
-	obs_websocket_vendor_register_request(vendor, "status", vendor_request_status, nullptr);
-	obs_websocket_vendor_register_request(vendor, "start_streaming", vendor_request_invoke, (void *)"StartStream");
-	obs_websocket_vendor_register_request(vendor, "stop_streaming", vendor_request_invoke, (void *)"StopStream");
-	obs_websocket_vendor_register_request(vendor, "toggle_streaming", vendor_request_invoke, (void *)"StreamButtonClicked");
-	obs_websocket_vendor_register_request(vendor, "start_recording", vendor_request_invoke, (void *)"StartRecord");
-	obs_websocket_vendor_register_request(vendor, "stop_recording", vendor_request_invoke, (void *)"StopRecord");
-	obs_websocket_vendor_register_request(vendor, "toggle_recording", vendor_request_invoke, (void *)"RecordButtonClicked");
-	obs_websocket_vendor_register_request(vendor, "start_backtrack", vendor_request_invoke, (void *)"StartReplayBuffer");
-	obs_websocket_vendor_register_request(vendor, "stop_backtrack", vendor_request_invoke, (void *)"StopReplayBuffer");
-	obs_websocket_vendor_register_request(vendor, "save_backtrack", vendor_request_save_replay, nullptr);
-	obs_websocket_vendor_register_request(vendor, "start_virtual_camera", vendor_request_invoke, (void *)"StartVirtualCam");
-	obs_websocket_vendor_register_request(vendor, "stop_virtual_camera", vendor_request_invoke, (void *)"StopVirtualCam");
-	obs_websocket_vendor_register_request(vendor, "update_stream_key", vendor_request_update_stream_key, nullptr);
-	obs_websocket_vendor_register_request(vendor, "update_stream_server", vendor_request_update_stream_server, nullptr);
+	for (const auto &request : vendor_requests)
+		obs_websocket_vendor_register_request(vendor, request.type, request.callback, request.param);
 
 	verison_update_info = update_info_create_single("[Vertical Canvas]", "OBS", "https://api.aitum.tv/vertical",
 							version_info_downloaded, nullptr);
@@ -540,27 +814,12 @@ void obs_module_post_load(void)
 void obs_module_unload(void)
 {
 	if (vendor && obs_get_module("obs-websocket")) {
-		obs_websocket_vendor_unregister_request(vendor, "version");
-		obs_websocket_vendor_unregister_request(vendor, "switch_scene");
-		obs_websocket_vendor_unregister_request(vendor, "current_scene");
-		obs_websocket_vendor_unregister_request(vendor, "get_scenes");
-		obs_websocket_vendor_unregister_request(vendor, "status");
-		obs_websocket_vendor_unregister_request(vendor, "start_streaming");
-		obs_websocket_vendor_unregister_request(vendor, "stop_streaming");
-		obs_websocket_vendor_unregister_request(vendor, "toggle_streaming");
-		obs_websocket_vendor_unregister_request(vendor, "start_recording");
-		obs_websocket_vendor_unregister_request(vendor, "stop_recording");
-		obs_websocket_vendor_unregister_request(vendor, "toggle_recording");
-		obs_websocket_vendor_unregister_request(vendor, "start_backtrack");
-		obs_websocket_vendor_unregister_request(vendor, "stop_backtrack");
-		obs_websocket_vendor_unregister_request(vendor, "save_backtrack");
-		obs_websocket_vendor_unregister_request(vendor, "start_virtual_camera");
-		obs_websocket_vendor_unregister_request(vendor, "stop_virtual_camera");
-		obs_websocket_vendor_unregister_request(vendor, "update_stream_key");
-		obs_websocket_vendor_unregister_request(vendor, "update_stream_server");
+		for (const auto &request : vendor_requests)
+			obs_websocket_vendor_unregister_request(vendor, request.type);
 	}
 	obs_frontend_remove_event_callback(frontend_event, nullptr);
 	update_info_destroy(verison_update_info);
+	config_writer.reset();
 }
 
 MODULE_EXPORT const char *obs_module_description(void)
@@ -666,6 +925,7 @@ void CanvasDock::AddScene(QString duplicate, bool ask_name)
 				}
 			}
 		}
+		QueueSave();
 	} while (ask_name && s);
 }
 
@@ -686,6 +946,7 @@ void CanvasDock::RemoveScene(const QString &sceneName)
 	mb.setDefaultButton(QMessageBox::NoButton);
 	if (mb.exec() == QMessageBox::Yes) {
 		obs_source_remove(s);
+		QueueSave();
 	}
 
 	obs_source_release(s);
@@ -805,6 +1066,12 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	  eventFilter(BuildEventFilter())
 {
 	view = obs_view_create();
+	prewarmTimer = new QTimer(this);
+	prewarmTimer->setSingleShot(true);
+	connect(prewarmTimer, &QTimer::timeout, this, &CanvasDock::ReleasePrewarm);
+	switchTimer = new QTimer(this);
+	switchTimer->setSingleShot(true);
+	connect(switchTimer, &QTimer::timeout, this, [this] { SwitchScene(pendingSwitchScene); });
 	auto ph = obs_get_proc_handler();
 	calldata_t cd = {0};
 	calldata_set_ptr(&cd, "view", view);
@@ -819,13 +1086,23 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		first_time = true;
 	}
 
+	canvas_id = obs_data_get_string(settings, "canvas_id");
+	if (canvas_id.empty() || canvas_index.count(canvas_id))
+		canvas_id = QUuid::createUuid().toString(QUuid::WithoutBraces).toStdString();
+	canvas_index[canvas_id] = this;
+
 	hideScenes = !obs_data_get_bool(settings, "show_scenes");
+	const bool render_cache = obs_data_get_bool(settings, "render_cache");
+	sharedTexture = obs_data_get_bool(settings, "shared_texture");
 	canvas_width = (uint32_t)obs_data_get_int(settings, "width");
 	canvas_height = (uint32_t)obs_data_get_int(settings, "height");
 	if (!canvas_width || !canvas_height) {
 		canvas_width = 1080;
 		canvas_height = 1920;
 	}
+	fps_divisor = (uint32_t)obs_data_get_int(settings, "fps_divisor");
+	if (!fps_divisor)
+		fps_divisor = 1;
 	streamingVideoBitrate = (uint32_t)obs_data_get_int(settings, "streaming_video_bitrate");
 	if (!streamingVideoBitrate)
 		streamingVideoBitrate = (uint32_t)obs_data_get_int(settings, "video_bitrate");
@@ -840,8 +1117,15 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	replayAlwaysOn = obs_data_get_bool(settings, "backtrack_always");
 	replayDuration = (uint32_t)obs_data_get_int(settings, "backtrack_seconds");
 	replayPath = obs_data_get_string(settings, "backtrack_path");
+	replayMaxSize = (uint32_t)obs_data_get_int(settings, "backtrack_max_size_mb");
+	replayDisk = obs_data_get_bool(settings, "backtrack_disk");
 
 	virtual_cam_mode = obs_data_get_int(settings, "virtual_camera_mode");
+	virtual_cam_width = (uint32_t)obs_data_get_int(settings, "virtual_camera_width");
+	virtual_cam_height = (uint32_t)obs_data_get_int(settings, "virtual_camera_height");
+	virtual_cam_format = (video_format)obs_data_get_int(settings, "virtual_camera_format");
+	if (virtual_cam_format != VIRTUAL_CAMERA_FORMAT)
+		virtual_cam_format = VIDEO_FORMAT_NONE;
 
 	auto so = obs_data_get_array(settings, "stream_outputs");
 	auto count = obs_data_array_count(so);
@@ -855,9 +1139,6 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		ss.enabled = obs_data_get_bool(item, "enabled");
 		if (ss.enabled)
 			enabled_count++;
-		std::string service_name = "vertical_canvas_stream_service_";
-		service_name += std::to_string(i);
-		ss.service = obs_service_create("rtmp_custom", service_name.c_str(), nullptr, nullptr);
 		streamOutputs.push_back(ss);
 		obs_data_release(item);
 	}
@@ -867,7 +1148,6 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		StreamServer ss;
 		ss.stream_server = obs_data_get_string(settings, "stream_server");
 		ss.stream_key = obs_data_get_string(settings, "stream_key");
-		ss.service = obs_service_create("rtmp_custom", "vertical_canvas_stream_service_0", nullptr, nullptr);
 		streamOutputs.push_back(ss);
 	}
 
@@ -916,26 +1196,39 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		const char *name = obs_source_get_display_name(id);
 
 		OBSSourceAutoRelease tr = obs_source_create_private(id, name, NULL);
-		transitions.emplace_back(tr);
+		AddTransition(tr);
 
 		//signals "transition_stop" and "transition_video_stop"
 		//        TransitionFullyStopped TransitionStopped
 	}
 
+	// only the selected transition is needed to show the canvas, the others are loaded after startup
+	// into their saved position
+	const char *selected_transition = obs_data_get_string(settings, "transition");
 	obs_data_array_t *transition_array = obs_data_get_array(settings, "transitions");
 	if (transition_array) {
+		deferredTransitionsPos = transitions.size();
+		bool defer = false;
 		size_t c = obs_data_array_count(transition_array);
 		for (size_t i = 0; i < c; i++) {
 			obs_data_t *td = obs_data_array_item(transition_array, i);
 			if (!td)
 				continue;
-			OBSSourceAutoRelease transition = obs_load_private_source(td);
-			if (transition)
-				transitions.emplace_back(transition);
-
+			if (strcmp(obs_data_get_string(td, "name"), selected_transition) == 0) {
+				OBSSourceAutoRelease transition = obs_load_private_source(td);
+				if (transition)
+					AddTransition(transition);
+			} else {
+				defer = true;
+			}
 			obs_data_release(td);
 		}
-		obs_data_array_release(transition_array);
+		if (defer) {
+			deferredTransitions = transition_array;
+			QTimer::singleShot(0, this, [this] { LoadDeferredTransitions(); });
+		} else {
+			obs_data_array_release(transition_array);
+		}
 	}
 
 	auto transition = GetTransition(obs_data_get_string(settings, "transition"));
@@ -950,12 +1243,8 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 
 	const QString title = QString::fromUtf8(obs_module_text("Vertical"));
 
-	const QString replayName = title + " " + QString::fromUtf8(obs_module_text("Backtrack"));
-	auto hotkeyData = obs_data_get_obj(settings, "backtrack_hotkeys");
-	replayOutput = obs_output_create("replay_buffer", replayName.toUtf8().constData(), nullptr, hotkeyData);
-	obs_data_release(hotkeyData);
-	auto rpsh = obs_output_get_signal_handler(replayOutput);
-	signal_handler_connect(rpsh, "saved", replay_saved, this);
+	// the backtrack output and its save hotkey are created after load or on first use
+	replayHotkeys = obs_data_get_obj(settings, "backtrack_hotkeys");
 
 	if (obs_data_get_bool(settings, "scenes_row")) {
 		CreateScenesRow();
@@ -1011,6 +1300,22 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	transitionsDockAction = (QAction *)obs_frontend_add_dock(dock);
 #endif
 
+	statsDock = new CanvasStatsDock(this, parent);
+	const auto statsName = "VerticalCanvasDockStats";
+	const auto statsTitle = title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats"));
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(30, 0, 0)
+	obs_frontend_add_dock_by_id(statsName, statsTitle.toUtf8().constData(), statsDock);
+#else
+	dock = new QDockWidget(mainDialog);
+	dock->setObjectName(QString::fromUtf8(statsName));
+	dock->setWindowTitle(statsTitle);
+	dock->setWidget(statsDock);
+	dock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+	dock->setFloating(true);
+	dock->hide();
+	statsDockAction = (QAction *)obs_frontend_add_dock(dock);
+#endif
+
 	preview->setObjectName(QStringLiteral("preview"));
 	preview->setMinimumSize(QSize(24, 24));
 	QSizePolicy sizePolicy1(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -1202,6 +1507,11 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	});
 	recordDurationTimer.start();
 
+	statsTimer.setInterval(1000);
+	statsTimer.setSingleShot(false);
+	connect(&statsTimer, &QTimer::timeout, [this] { UpdateStats(); });
+	statsTimer.start();
+
 	replayStatusResetTimer.setInterval(4000);
 	replayStatusResetTimer.setSingleShot(true);
 	connect(&replayStatusResetTimer, &QTimer::timeout, [this] { statusLabel->setText(""); });
@@ -1237,6 +1547,8 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 
 	obs_leave_graphics();
 
+	spacerAtlas = std::make_unique<LabelAtlas>(16);
+
 	currentSceneName = QString::fromUtf8(obs_data_get_string(settings, "current_scene"));
 
 	auto sh = obs_get_signal_handler();
@@ -1294,22 +1606,37 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		obs_source_create_private("vertical_audio_wrapper_source", "vertical_audio_wrapper_source", nullptr);
 	auto aw = (struct audio_wrapper_info *)obs_obj_get_data(transitionAudioWrapper);
 	aw->param = this;
+	aw->metrics = metrics.GetRing(CanvasMetric::AudioWrapperRender);
 	aw->target = [](void *param) {
 		CanvasDock *dock = reinterpret_cast<CanvasDock *>(param);
 		return obs_weak_source_get_source(dock->source);
 	};
-	StartVideo();
+	// the view always renders the canvas for the preview, the video mix is
+	// only added while an output consumes it
+	auto vs = obs_weak_source_get_source(source);
+	obs_view_set_source(view, 0, vs);
+	obs_source_release(vs);
+	if (render_cache)
+		SetRenderCache(true);
 }
 
 CanvasDock::~CanvasDock()
 {
+	ReleasePrewarm();
+	// drains the backtrack saver before anything its callbacks reach is torn down
+	diskBacktrack.reset();
 	for (auto projector : projectors) {
 		delete projector;
 	}
 	canvas_docks.remove(this);
+	UpdateBacktrackShares();
+	auto indexed = canvas_index.find(canvas_id);
+	if (indexed != canvas_index.end() && indexed->second == this)
+		canvas_index.erase(indexed);
 	obs_hotkey_pair_unregister(virtual_cam_hotkey);
 	obs_hotkey_pair_unregister(record_hotkey);
 	obs_hotkey_pair_unregister(stream_hotkey);
+	obs_hotkey_unregister(backtrack_hotkey);
 	obs_display_remove_draw_callback(preview->GetDisplay(), DrawPreview, this);
 	for (uint32_t i = MAX_CHANNELS - 1; i > 0; i--) {
 		auto s = obs_get_output_source(i);
@@ -1322,9 +1649,11 @@ CanvasDock::~CanvasDock()
 	}
 	obs_source_release(transitionAudioWrapper);
 	transitionAudioWrapper = nullptr;
+	statsTimer.stop();
 	sourcesDock = nullptr;
 	scenesDock = nullptr;
 	transitionsDock = nullptr;
+	statsDock = nullptr;
 	auto sh = obs_get_signal_handler();
 	signal_handler_disconnect(sh, "source_rename", source_rename, this);
 	signal_handler_disconnect(sh, "source_remove", source_remove, this);
@@ -1340,10 +1669,12 @@ CanvasDock::~CanvasDock()
 	if (obs_output_active(replayOutput))
 		obs_output_stop(replayOutput);
 	obs_output_release(replayOutput);
+	obs_data_release(replayHotkeys);
 
 	if (obs_output_active(virtualCamOutput))
 		obs_output_stop(virtualCamOutput);
 	obs_output_release(virtualCamOutput);
+	ReleaseVirtualCamVideo();
 
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (obs_output_active(it->output))
@@ -1380,10 +1711,16 @@ CanvasDock::~CanvasDock()
 
 	if (video) {
 		video = nullptr;
+		videoConsumers = 0;
 		obs_view_remove(view);
-		obs_view_set_source(view, 0, nullptr);
 	}
+	obs_view_set_source(view, 0, nullptr);
 	obs_view_destroy(view);
+	if (renderCache) {
+		render_cache_source_set_target(obs_obj_get_data(renderCache), nullptr);
+		obs_source_release(renderCache);
+		renderCache = nullptr;
+	}
 
 	obs_enter_graphics();
 
@@ -1409,6 +1746,9 @@ CanvasDock::~CanvasDock()
 	obs_source_release(oldTransition);
 
 	transitions.clear();
+	transitionIndex.clear();
+	obs_data_array_release(deferredTransitions);
+	deferredTransitions = nullptr;
 }
 
 void CanvasDock::setAction(QAction *a)
@@ -1584,6 +1924,7 @@ void CanvasDock::DrawBackdrop(float cx, float cy)
 void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 {
 	CanvasDock *window = static_cast<CanvasDock *>(data);
+	const uint64_t start = os_gettime_ns();
 
 	uint32_t sourceCX = window->canvas_width;
 	if (sourceCX <= 0)
@@ -1621,7 +1962,7 @@ void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 
 	gs_ortho(0.0f, float(sourceCX), 0.0f, float(sourceCY), -100.0f, 100.0f);
 	gs_set_viewport(x, y, newCX, newCY);
-	obs_view_render(window->view);
+	window->RenderView();
 
 	gs_set_linear_srgb(previous);
 
@@ -1666,6 +2007,8 @@ void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 
 	gs_projection_pop();
 	gs_viewport_pop();
+
+	metrics_ring_push(window->metrics.GetRing(CanvasMetric::DrawPreview), os_gettime_ns() - start);
 }
 
 struct SceneFindData {
@@ -1687,6 +2030,7 @@ struct SceneFindBoxData {
 	const vec2 &startPos;
 	const vec2 &pos;
 	std::vector<obs_sceneitem_t *> sceneItems;
+	std::vector<matrix4> transforms;
 
 	SceneFindBoxData(const SceneFindData &) = delete;
 	SceneFindBoxData(SceneFindData &&) = delete;
@@ -1728,14 +2072,6 @@ static vec2 GetItemSize(obs_sceneitem_t *item)
 	return size;
 }
 
-static vec3 GetTransformedPos(float x, float y, const matrix4 &mat)
-{
-	vec3 result;
-	vec3_set(&result, x, y, 0.0f);
-	vec3_transform(&result, &result, &mat);
-	return result;
-}
-
 static void DrawLine(float x1, float y1, float x2, float y2, float thickness, vec2 scale)
 {
 	float ySide = (y1 == y2) ? (y1 < 0.5f ? 1.0f : -1.0f) : 0.0f;
@@ -1791,26 +2127,9 @@ void CanvasDock::DrawSpacingLine(vec3 &start, vec3 &end, vec3 &viewport, float p
 	gs_technique_end(tech);
 }
 
-void CanvasDock::SetLabelText(int sourceIndex, int px)
-{
-
-	if (px == spacerPx[sourceIndex])
-		return;
-
-	std::string text = std::to_string(px) + " px";
-
-	obs_source_t *source = spacerLabel[sourceIndex];
-
-	OBSDataAutoRelease settings = obs_source_get_settings(source);
-	obs_data_set_string(settings, "text", text.c_str());
-	obs_source_update(source, settings);
-
-	spacerPx[sourceIndex] = px;
-}
-
-static void DrawLabel(OBSSource source, vec3 &pos, vec3 &viewport)
+static void DrawLabel(LabelAtlas *atlas, const char *text, vec3 &pos, vec3 &viewport)
 {
-	if (!source)
+	if (!atlas)
 		return;
 
 	vec3_mul(&pos, &pos, &viewport);
@@ -1818,7 +2137,7 @@ static void DrawLabel(OBSSource source, vec3 &pos, vec3 &viewport)
 	gs_matrix_push();
 	gs_matrix_identity();
 	gs_matrix_translate(&pos);
-	obs_source_video_render(source);
+	atlas->Draw(text);
 	gs_matrix_pop();
 }
 
@@ -1843,9 +2162,10 @@ void CanvasDock::RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, ve
 	if (px <= 0.0f)
 		return;
 
-	obs_source_t *source = spacerLabel[sourceIndex];
+	char text[32];
+	snprintf(text, sizeof(text), "%d px", (int)px);
 	vec3 labelSize, labelPos;
-	vec3_set(&labelSize, obs_source_get_width(source), obs_source_get_height(source), 1.0f);
+	vec3_set(&labelSize, spacerAtlas->Width(text), spacerAtlas->Height(), 1.0f);
 
 	vec3_div(&labelSize, &labelSize, &viewport);
 
@@ -1865,39 +2185,7 @@ void CanvasDock::RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, ve
 	}
 
 	DrawSpacingLine(start, end, viewport, pixelRatio);
-	SetLabelText(sourceIndex, (int)px);
-	DrawLabel(source, labelPos, viewport);
-}
-
-static obs_source_t *CreateLabel(float pixelRatio)
-{
-	OBSDataAutoRelease settings = obs_data_create();
-	OBSDataAutoRelease font = obs_data_create();
-
-#if defined(_WIN32)
-	obs_data_set_string(font, "face", "Arial");
-#elif defined(__APPLE__)
-	obs_data_set_string(font, "face", "Helvetica");
-#else
-	obs_data_set_string(font, "face", "Monospace");
-#endif
-	obs_data_set_int(font, "flags", 1); // Bold text
-	obs_data_set_int(font, "size", 16 * pixelRatio);
-
-	obs_data_set_obj(settings, "font", font);
-	obs_data_set_bool(settings, "outline", true);
-
-#ifdef _WIN32
-	obs_data_set_int(settings, "outline_color", 0x000000);
-	obs_data_set_int(settings, "outline_size", 3);
-	const char *text_source_id = "text_gdiplus";
-#else
-	const char *text_source_id = "text_ft2_source";
-#endif
-
-	OBSSource txtSource = obs_source_create_private(text_source_id, nullptr, settings);
-
-	return txtSource;
+	DrawLabel(spacerAtlas.get(), text, labelPos, viewport);
 }
 
 obs_scene_item *CanvasDock::GetSelectedItem(obs_scene_t *s)
@@ -2053,10 +2341,8 @@ void CanvasDock::DrawSpacingHelpers(obs_scene_t *scene, float x, float y, float
 	vec3 start, end;
 
 	float pixelRatio = 1.0f; //main->GetDevicePixelRatio();
-	for (int i = 0; i < 4; i++) {
-		if (!spacerLabel[i])
-			spacerLabel[i] = CreateLabel(pixelRatio);
-	}
+	if (!spacerAtlas)
+		return;
 
 	vec3_set(&start, top.x, 0.0f, 1.0f);
 	vec3_set(&end, top.x, top.y, 1.0f);
@@ -2564,22 +2850,7 @@ static void GetItemBox(obs_sceneitem_t *item, vec3 &tl, vec3 &br)
 {
 	matrix4 boxTransform;
 	obs_sceneitem_get_box_transform(item, &boxTransform);
-
-	vec3_set(&tl, M_INFINITE, M_INFINITE, 0.0f);
-	vec3_set(&br, -M_INFINITE, -M_INFINITE, 0.0f);
-
-	auto GetMinPos = [&](float x, float y) {
-		vec3 pos;
-		vec3_set(&pos, x, y, 0.0f);
-		vec3_transform(&pos, &pos, &boxTransform);
-		vec3_min(&tl, &tl, &pos);
-		vec3_max(&br, &br, &pos);
-	};
-
-	GetMinPos(0.0f, 0.0f);
-	GetMinPos(1.0f, 0.0f);
-	GetMinPos(0.0f, 1.0f);
-	GetMinPos(1.0f, 1.0f);
+	GetTransformedBounds(boxTransform, tl, br);
 }
 
 static vec3 GetItemTL(obs_sceneitem_t *item)
@@ -3337,26 +3608,15 @@ static bool FindItemAtPos(obs_scene_t *scene, obs_sceneitem_t *item, void *param
 {
 	SceneFindData *data = reinterpret_cast<SceneFindData *>(param);
 	matrix4 transform;
-	matrix4 invTransform;
-	vec3 transformedPos;
-	vec3 pos3;
-	vec3 pos3_;
 
 	if (!SceneItemHasVideo(item))
 		return true;
 	if (obs_sceneitem_locked(item))
 		return true;
 
-	vec3_set(&pos3, data->pos.x, data->pos.y, 0.0f);
-
 	obs_sceneitem_get_box_transform(item, &transform);
 
-	matrix4_inv(&invTransform, &transform);
-	vec3_transform(&transformedPos, &pos3, &invTransform);
-	vec3_transform(&pos3_, &transformedPos, &transform);
-
-	if (CloseFloat(pos3.x, pos3_.x) && CloseFloat(pos3.y, pos3_.y) && transformedPos.x >= 0.0f && transformedPos.x <= 1.0f &&
-	    transformedPos.y >= 0.0f && transformedPos.y <= 1.0f) {
+	if (ItemContainsPos(transform, data->pos)) {
 		if (data->selectBelow && obs_sceneitem_selected(item)) {
 			if (data->item)
 				return false;
@@ -3435,19 +3695,6 @@ void CanvasDock::UpdateCursor(uint32_t &flags)
 		setCursor(Qt::OpenHandCursor);
 }
 
-static void RotatePos(vec2 *pos, float rot)
-{
-	float cosR = cos(rot);
-	float sinR = sin(rot);
-
-	vec2 newPos;
-
-	newPos.x = cosR * pos->x - sinR * pos->y;
-	newPos.y = sinR * pos->x + cosR * pos->y;
-
-	vec2_copy(pos, &newPos);
-}
-
 void CanvasDock::RotateItem(const vec2 &pos)
 {
 	Qt::KeyboardModifiers modifiers = QGuiApplication::keyboardModifiers();
@@ -3653,7 +3900,7 @@ void CanvasDock::StretchItem(const vec2 &pos)
 
 	if (boundsType != OBS_BOUNDS_NONE) {
 		if (shiftDown)
-			ClampAspect(tl, br, size, baseSize);
+			ClampAspect(tl, br, size, baseSize, (uint32_t)stretchHandle);
 
 		if (tl.x > br.x)
 			std::swap(tl.x, br.x);
@@ -3671,13 +3918,13 @@ void CanvasDock::StretchItem(const vec2 &pos)
 		baseSize.y -= float(crop.top + crop.bottom);
 
 		if (!shiftDown)
-			ClampAspect(tl, br, size, baseSize);
+			ClampAspect(tl, br, size, baseSize, (uint32_t)stretchHandle);
 
 		vec2_div(&size, &size, &baseSize);
 		obs_sceneitem_set_scale(stretchItem, &size);
 	}
 
-	pos3 = CalculateStretchPos(tl, br);
+	pos3 = CalculateStretchPos(tl, br, obs_sceneitem_get_alignment(stretchItem));
 	vec3_transform(&pos3, &pos3, &itemToScreen);
 
 	vec2 newPos;
@@ -3744,30 +3991,7 @@ vec3 CanvasDock::GetSnapOffset(const vec3 &tl, const vec3 &br)
 	const bool centerSnap = config_get_bool(config, "BasicWindow", "CenterSnapping");
 
 	const float clampDist = config_get_double(config, "BasicWindow", "SnapDistance") / previewScale;
-	const float centerX = br.x - (br.x - tl.x) / 2.0f;
-	const float centerY = br.y - (br.y - tl.y) / 2.0f;
-
-	// Left screen edge.
-	if (screenSnap && fabsf(tl.x) < clampDist)
-		clampOffset.x = -tl.x;
-	// Right screen edge.
-	if (screenSnap && fabsf(clampOffset.x) < EPSILON && fabsf(screenSize.x - br.x) < clampDist)
-		clampOffset.x = screenSize.x - br.x;
-	// Horizontal center.
-	if (centerSnap && fabsf(screenSize.x - (br.x - tl.x)) > clampDist && fabsf(screenSize.x / 2.0f - centerX) < clampDist)
-		clampOffset.x = screenSize.x / 2.0f - centerX;
-
-	// Top screen edge.
-	if (screenSnap && fabsf(tl.y) < clampDist)
-		clampOffset.y = -tl.y;
-	// Bottom screen edge.
-	if (screenSnap && fabsf(clampOffset.y) < EPSILON && fabsf(screenSize.y - br.y) < clampDist)
-		clampOffset.y = screenSize.y - br.y;
-	// Vertical center.
-	if (centerSnap && fabsf(screenSize.y - (br.y - tl.y)) > clampDist && fabsf(screenSize.y / 2.0f - centerY) < clampDist)
-		clampOffset.y = screenSize.y / 2.0f - centerY;
-
-	return clampOffset;
+	return GetScreenSnapOffset(tl, br, screenSize, clampDist, screenSnap, centerSnap);
 }
 
 static bool move_items(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
@@ -3890,38 +4114,10 @@ static bool GetSourceSnapOffset(obs_scene_t *scene, obs_sceneitem_t *item, void
 	matrix4 boxTransform;
 	obs_sceneitem_get_box_transform(item, &boxTransform);
 
-	vec3 t[4] = {GetTransformedPos(0.0f, 0.0f, boxTransform), GetTransformedPos(1.0f, 0.0f, boxTransform),
-		     GetTransformedPos(0.0f, 1.0f, boxTransform), GetTransformedPos(1.0f, 1.0f, boxTransform)};
-
-	bool first = true;
-	vec3 tl, br;
-	vec3_zero(&tl);
-	vec3_zero(&br);
-	for (const vec3 &v : t) {
-		if (first) {
-			vec3_copy(&tl, &v);
-			vec3_copy(&br, &v);
-			first = false;
-		} else {
-			vec3_min(&tl, &tl, &v);
-			vec3_max(&br, &br, &v);
-		}
-	}
-
 	// Snap to other source edges
-#define EDGE_SNAP(l, r, x, y)                                                                                              \
-	do {                                                                                                               \
-		double dist = fabsf(l.x - data->r.x);                                                                      \
-		if (dist < data->clampDist && fabsf(data->offset.x) < EPSILON && data->tl.y < br.y && data->br.y > tl.y && \
-		    (fabsf(data->offset.x) > dist || data->offset.x < EPSILON))                                            \
-			data->offset.x = l.x - data->r.x;                                                                  \
-	} while (false)
-
-	EDGE_SNAP(tl, br, x, y);
-	EDGE_SNAP(tl, br, y, x);
-	EDGE_SNAP(br, tl, x, y);
-	EDGE_SNAP(br, tl, y, x);
-#undef EDGE_SNAP
+	vec3 tl, br;
+	GetTransformedBounds(boxTransform, tl, br);
+	SnapToItemEdges(data->tl, data->br, tl, br, data->clampDist, data->offset);
 
 	UNUSED_PARAMETER(scene);
 	return true;
@@ -3972,148 +4168,27 @@ void CanvasDock::SnapItemMovement(vec2 &offset)
 	}
 }
 
-static bool CounterClockwise(float x1, float x2, float x3, float y1, float y2, float y3)
+static bool FindItemsInBox(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
 {
-	return (y3 - y1) * (x2 - x1) > (y2 - y1) * (x3 - x1);
-}
+	SceneFindBoxData *data = reinterpret_cast<SceneFindBoxData *>(param);
 
-static bool IntersectLine(float x1, float x2, float x3, float x4, float y1, float y2, float y3, float y4)
-{
-	bool a = CounterClockwise(x1, x2, x3, y1, y2, y3);
-	bool b = CounterClockwise(x1, x2, x4, y1, y2, y4);
-	bool c = CounterClockwise(x3, x4, x1, y3, y4, y1);
-	bool d = CounterClockwise(x3, x4, x2, y3, y4, y2);
+	if (!SceneItemHasVideo(item))
+		return true;
+	if (obs_sceneitem_locked(item))
+		return true;
+	if (!obs_sceneitem_visible(item))
+		return true;
+
+	matrix4 transform;
+	obs_sceneitem_get_box_transform(item, &transform);
+	data->sceneItems.push_back(item);
+	data->transforms.push_back(transform);
 
-	return (a != b) && (c != d);
+	UNUSED_PARAMETER(scene);
+	return true;
 }
 
-static bool IntersectBox(matrix4 transform, float x1, float x2, float y1, float y2)
-{
-	float x3, x4, y3, y4;
-
-	x3 = transform.t.x;
-	y3 = transform.t.y;
-	x4 = x3 + transform.x.x;
-	y4 = y3 + transform.x.y;
-
-	if (IntersectLine(x1, x1, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y1, y1, y3, y4) ||
-	    IntersectLine(x2, x2, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y2, y2, y3, y4))
-		return true;
-
-	x4 = x3 + transform.y.x;
-	y4 = y3 + transform.y.y;
-
-	if (IntersectLine(x1, x1, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y1, y1, y3, y4) ||
-	    IntersectLine(x2, x2, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y2, y2, y3, y4))
-		return true;
-
-	x3 = transform.t.x + transform.x.x;
-	y3 = transform.t.y + transform.x.y;
-	x4 = x3 + transform.y.x;
-	y4 = y3 + transform.y.y;
-
-	if (IntersectLine(x1, x1, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y1, y1, y3, y4) ||
-	    IntersectLine(x2, x2, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y2, y2, y3, y4))
-		return true;
-
-	x3 = transform.t.x + transform.y.x;
-	y3 = transform.t.y + transform.y.y;
-	x4 = x3 + transform.x.x;
-	y4 = y3 + transform.x.y;
-
-	if (IntersectLine(x1, x1, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y1, y1, y3, y4) ||
-	    IntersectLine(x2, x2, x3, x4, y1, y2, y3, y4) || IntersectLine(x1, x2, x3, x4, y2, y2, y3, y4))
-		return true;
-
-	return false;
-}
-
-static bool FindItemsInBox(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
-{
-	SceneFindBoxData *data = reinterpret_cast<SceneFindBoxData *>(param);
-	matrix4 transform;
-	matrix4 invTransform;
-	vec3 transformedPos;
-	vec3 pos3;
-	vec3 pos3_;
-
-	vec2 pos_min, pos_max;
-	vec2_min(&pos_min, &data->startPos, &data->pos);
-	vec2_max(&pos_max, &data->startPos, &data->pos);
-
-	const float x1 = pos_min.x;
-	const float x2 = pos_max.x;
-	const float y1 = pos_min.y;
-	const float y2 = pos_max.y;
-
-	if (!SceneItemHasVideo(item))
-		return true;
-	if (obs_sceneitem_locked(item))
-		return true;
-	if (!obs_sceneitem_visible(item))
-		return true;
-
-	vec3_set(&pos3, data->pos.x, data->pos.y, 0.0f);
-
-	obs_sceneitem_get_box_transform(item, &transform);
-
-	matrix4_inv(&invTransform, &transform);
-	vec3_transform(&transformedPos, &pos3, &invTransform);
-	vec3_transform(&pos3_, &transformedPos, &transform);
-
-	if (CloseFloat(pos3.x, pos3_.x) && CloseFloat(pos3.y, pos3_.y) && transformedPos.x >= 0.0f && transformedPos.x <= 1.0f &&
-	    transformedPos.y >= 0.0f && transformedPos.y <= 1.0f) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (transform.t.x > x1 && transform.t.x < x2 && transform.t.y > y1 && transform.t.y < y2) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (transform.t.x + transform.x.x > x1 && transform.t.x + transform.x.x < x2 && transform.t.y + transform.x.y > y1 &&
-	    transform.t.y + transform.x.y < y2) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (transform.t.x + transform.y.x > x1 && transform.t.x + transform.y.x < x2 && transform.t.y + transform.y.y > y1 &&
-	    transform.t.y + transform.y.y < y2) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (transform.t.x + transform.x.x + transform.y.x > x1 && transform.t.x + transform.x.x + transform.y.x < x2 &&
-	    transform.t.y + transform.x.y + transform.y.y > y1 && transform.t.y + transform.x.y + transform.y.y < y2) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (transform.t.x + 0.5 * (transform.x.x + transform.y.x) > x1 &&
-	    transform.t.x + 0.5 * (transform.x.x + transform.y.x) < x2 &&
-	    transform.t.y + 0.5 * (transform.x.y + transform.y.y) > y1 &&
-	    transform.t.y + 0.5 * (transform.x.y + transform.y.y) < y2) {
-
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	if (IntersectBox(transform, x1, x2, y1, y2)) {
-		data->sceneItems.push_back(item);
-		return true;
-	}
-
-	UNUSED_PARAMETER(scene);
-	return true;
-}
-
-void CanvasDock::BoxItems(const vec2 &startPos, const vec2 &pos)
+void CanvasDock::BoxItems(const vec2 &startPos, const vec2 &pos)
 {
 	if (!scene)
 		return;
@@ -4124,8 +4199,21 @@ void CanvasDock::BoxItems(const vec2 &startPos, const vec2 &pos)
 	SceneFindBoxData data(startPos, pos);
 	obs_scene_enum_items(scene, FindItemsInBox, &data);
 
+	vec2 pos_min, pos_max;
+	vec2_min(&pos_min, &startPos, &pos);
+	vec2_max(&pos_max, &startPos, &pos);
+
+	std::vector<uint8_t> hits(data.transforms.size());
+	BoxHitTest(data.transforms.data(), data.transforms.size(), pos, pos_min.x, pos_max.x, pos_min.y, pos_max.y, hits.data());
+
+	std::vector<obs_sceneitem_t *> items;
+	for (size_t i = 0; i < hits.size(); i++) {
+		if (hits[i])
+			items.push_back(data.sceneItems[i]);
+	}
+
 	std::lock_guard<std::mutex> lock(selectMutex);
-	hoveredPreviewItems = data.sceneItems;
+	hoveredPreviewItems = std::move(items);
 }
 
 struct HandleFindData {
@@ -4302,77 +4390,6 @@ void CanvasDock::GetStretchHandleData(const vec2 &pos, bool ignoreGroup)
 	}
 }
 
-void CanvasDock::ClampAspect(vec3 &tl, vec3 &br, vec2 &size, const vec2 &baseSize)
-{
-	float baseAspect = baseSize.x / baseSize.y;
-	float aspect = size.x / size.y;
-	uint32_t stretchFlags = (uint32_t)stretchHandle;
-
-	if (stretchHandle == ItemHandle::TopLeft || stretchHandle == ItemHandle::TopRight ||
-	    stretchHandle == ItemHandle::BottomLeft || stretchHandle == ItemHandle::BottomRight) {
-		if (aspect < baseAspect) {
-			if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
-				size.x = size.y * baseAspect;
-			else
-				size.x = size.y * baseAspect * -1.0f;
-		} else {
-			if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
-				size.y = size.x / baseAspect;
-			else
-				size.y = size.x / baseAspect * -1.0f;
-		}
-
-	} else if (stretchHandle == ItemHandle::TopCenter || stretchHandle == ItemHandle::BottomCenter) {
-		if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
-			size.x = size.y * baseAspect;
-		else
-			size.x = size.y * baseAspect * -1.0f;
-
-	} else if (stretchHandle == ItemHandle::CenterLeft || stretchHandle == ItemHandle::CenterRight) {
-		if ((size.y >= 0.0f && size.x >= 0.0f) || (size.y <= 0.0f && size.x <= 0.0f))
-			size.y = size.x / baseAspect;
-		else
-			size.y = size.x / baseAspect * -1.0f;
-	}
-
-	size.x = std::round(size.x);
-	size.y = std::round(size.y);
-
-	if (stretchFlags & ITEM_LEFT)
-		tl.x = br.x - size.x;
-	else if (stretchFlags & ITEM_RIGHT)
-		br.x = tl.x + size.x;
-
-	if (stretchFlags & ITEM_TOP)
-		tl.y = br.y - size.y;
-	else if (stretchFlags & ITEM_BOTTOM)
-		br.y = tl.y + size.y;
-}
-
-vec3 CanvasDock::CalculateStretchPos(const vec3 &tl, const vec3 &br)
-{
-	uint32_t alignment = obs_sceneitem_get_alignment(stretchItem);
-	vec3 pos;
-
-	vec3_zero(&pos);
-
-	if (alignment & OBS_ALIGN_LEFT)
-		pos.x = tl.x;
-	else if (alignment & OBS_ALIGN_RIGHT)
-		pos.x = br.x;
-	else
-		pos.x = (br.x - tl.x) * 0.5f + tl.x;
-
-	if (alignment & OBS_ALIGN_TOP)
-		pos.y = tl.y;
-	else if (alignment & OBS_ALIGN_BOTTOM)
-		pos.y = br.y;
-	else
-		pos.y = (br.y - tl.y) * 0.5f + tl.y;
-
-	return pos;
-}
-
 bool CanvasDock::DrawSelectionBox(float x1, float y1, float x2, float y2, gs_vertbuffer_t *rectFill)
 {
 	float pixelRatio = GetDevicePixelRatio();
@@ -4579,31 +4596,144 @@ void CanvasDock::AddSourceFromAction()
 	}
 }
 
-bool CanvasDock::StartVideo()
+video_t *CanvasDock::AcquireVideo(uint32_t consumer)
 {
-	if (!view)
-		view = obs_view_create();
+	if (!video) {
+		obs_video_info ovi;
+		obs_get_video_info(&ovi);
+		ovi.base_width = canvas_width;
+		ovi.base_height = canvas_height;
+		ovi.output_width = canvas_width;
+		ovi.output_height = canvas_height;
+		video = obs_view_add2(view, &ovi);
+		if (!video) {
+			blog(LOG_WARNING, "[Vertical Canvas] failed to add video mix %ux%u", canvas_width, canvas_height);
+			return nullptr;
+		}
+	}
+	videoConsumers |= consumer;
+	return video;
+}
 
-	auto s = obs_weak_source_get_source(source);
+void CanvasDock::ReleaseVideo(uint32_t consumer)
+{
+	if ((videoConsumers & consumer) == 0)
+		return;
+	videoConsumers &= ~consumer;
+	if (videoConsumers || !video)
+		return;
+	video = nullptr;
+	obs_view_remove(view);
+}
+
+video_t *CanvasDock::AcquireVirtualCamVideo()
+{
+	const bool scaled = virtual_cam_width && virtual_cam_height &&
+			    (virtual_cam_width != canvas_width || virtual_cam_height != canvas_height);
+	if (!scaled && virtual_cam_format == VIDEO_FORMAT_NONE)
+		return AcquireVideo(VIDEO_CONSUMER_VIRTUAL_CAM);
+
+	// a dedicated mix scales and converts on the gpu so the virtual camera
+	// gets frames it does not have to convert on the cpu
+	if (!virtualCamView)
+		virtualCamView = obs_view_create();
+	obs_source_t *s = obs_view_get_source(view, 0);
+	obs_view_set_source(virtualCamView, 0, s);
+	obs_source_release(s);
+	if (!virtualCamVideo) {
+		obs_video_info ovi;
+		obs_get_video_info(&ovi);
+		ovi.base_width = canvas_width;
+		ovi.base_height = canvas_height;
+		ovi.output_width = scaled ? virtual_cam_width : canvas_width;
+		ovi.output_height = scaled ? virtual_cam_height : canvas_height;
+		if (virtual_cam_format != VIDEO_FORMAT_NONE)
+			ovi.output_format = virtual_cam_format;
+		virtualCamVideo = obs_view_add2(virtualCamView, &ovi);
+		if (!virtualCamVideo)
+			blog(LOG_WARNING, "[Vertical Canvas] failed to add virtual camera video mix %ux%u %s", ovi.output_width,
+			     ovi.output_height, get_video_format_name(ovi.output_format));
+	}
+	return virtualCamVideo;
+}
+
+void CanvasDock::ReleaseVirtualCamVideo()
+{
+	ReleaseVideo(VIDEO_CONSUMER_VIRTUAL_CAM);
+	if (virtualCamVideo) {
+		virtualCamVideo = nullptr;
+		obs_view_remove(virtualCamView);
+	}
+	if (virtualCamView) {
+		obs_view_set_source(virtualCamView, 0, nullptr);
+		obs_view_destroy(virtualCamView);
+		virtualCamView = nullptr;
+	}
+}
+
+void CanvasDock::SetViewSource(obs_source_t *s)
+{
+	// with the render cache the views keep showing the cache source
+	if (renderCache) {
+		render_cache_source_set_target(obs_obj_get_data(renderCache), s);
+		return;
+	}
 	obs_view_set_source(view, 0, s);
+	if (virtualCamView)
+		obs_view_set_source(virtualCamView, 0, s);
+}
+
+void CanvasDock::SetRenderCache(bool enable)
+{
+	if (enable == (renderCache != nullptr))
+		return;
+	obs_source_t *s = obs_weak_source_get_source(source);
+	if (enable) {
+		renderCache = obs_source_create_private("vertical_render_cache_source", "vertical_render_cache_source", nullptr);
+		void *data = obs_obj_get_data(renderCache);
+		render_cache_source_set_size(data, canvas_width, canvas_height);
+		render_cache_source_set_metrics(data, metrics.GetRing(CanvasMetric::CanvasRender));
+		render_cache_source_set_target(data, s);
+		obs_view_set_source(view, 0, renderCache);
+		if (virtualCamView)
+			obs_view_set_source(virtualCamView, 0, renderCache);
+	} else {
+		obs_view_set_source(view, 0, s);
+		if (virtualCamView)
+			obs_view_set_source(virtualCamView, 0, s);
+		obs_source_t *cache = renderCache;
+		// the preview and projectors read it on the graphics thread
+		obs_enter_graphics();
+		renderCache = nullptr;
+		obs_leave_graphics();
+		render_cache_source_set_target(obs_obj_get_data(cache), nullptr);
+		obs_source_release(cache);
+	}
 	obs_source_release(s);
-	
-	obs_video_info ovi;
-	obs_get_video_info(&ovi);
-	ovi.base_width = canvas_width;
-	ovi.base_height = canvas_height;
-	ovi.output_width = canvas_width;
-	ovi.output_height = canvas_height;
-	video = obs_view_add2(view, &ovi);
-	
-	return true;
+}
+
+void CanvasDock::RenderView()
+{
+	// the frame the canvas output already rendered costs a single quad
+	if (!sharedTexture || !renderCache || !render_cache_source_draw_shared(obs_obj_get_data(renderCache))) {
+		obs_view_render(view);
+		return;
+	}
+	// the cache only holds channel 0, draw the channels above it like obs_view_render does
+	for (uint32_t i = 1; i < MAX_CHANNELS; i++) {
+		obs_source_t *s = obs_view_get_source(view, i);
+		if (!s)
+			continue;
+		obs_source_video_render(s);
+		obs_source_release(s);
+	}
 }
 
 void CanvasDock::virtual_cam_output_start(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("virtual_camera_started");
+	d->SendVendorEvent("virtual_camera_started", VENDOR_EVENT_VIRTUAL_CAMERA, d->virtualCamOutput);
 	d->StartReplayBuffer();
 	QMetaObject::invokeMethod(d, "OnVirtualCamStart");
 }
@@ -4612,13 +4742,14 @@ void CanvasDock::virtual_cam_output_stop(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("virtual_camera_stopped");
-	QMetaObject::invokeMethod(d, "OnVirtualCamStop");
+	d->SendVendorEvent("virtual_camera_stopped", VENDOR_EVENT_VIRTUAL_CAMERA, d->virtualCamOutput);
 	signal_handler_t *signal = obs_output_get_signal_handler(d->virtualCamOutput);
 	signal_handler_disconnect(signal, "start", virtual_cam_output_start, d);
 	signal_handler_disconnect(signal, "stop", virtual_cam_output_stop, d);
 	obs_output_release(d->virtualCamOutput);
 	d->virtualCamOutput = nullptr;
+	// queued last, OnVirtualCamStop may start the virtual camera again
+	QMetaObject::invokeMethod(d, "OnVirtualCamStop");
 }
 
 void CanvasDock::OnVirtualCamStart()
@@ -4633,6 +4764,7 @@ void CanvasDock::OnVirtualCamStop()
 	virtualCamButton->setIcon(virtualCamInactiveIcon);
 	virtualCamButton->setStyleSheet(QString::fromUtf8(""));
 	virtualCamButton->setChecked(false);
+	ReleaseVirtualCamVideo();
 	CheckReplayBuffer();
 	if (multiCanvasSource) {
 		multi_canvas_source_remove_view(obs_obj_get_data(multiCanvasSource), view);
@@ -4649,6 +4781,8 @@ void CanvasDock::OnVirtualCamStop()
 		obs_view_destroy(multiCanvasView);
 		multiCanvasView = nullptr;
 	}
+	if (restart_virtual_cam)
+		ProfileChanged();
 }
 
 void CanvasDock::VirtualCamButtonClicked()
@@ -4679,23 +4813,25 @@ void CanvasDock::StartVirtualCam()
 
 	virtualCamOutput = output;
 
-	obs_view_t *started_view = nullptr;
-	bool started_video = false;
 	video_t *virtual_video = nullptr;
 	if (virtual_cam_mode == VIRTUAL_CAMERA_VERTICAL) {
-		started_video = StartVideo();
-		started_view = view;
-		virtual_video = video;
+		virtual_video = AcquireVirtualCamVideo();
+		if (!virtual_video) {
+			virtualCamOutput = nullptr;
+			obs_output_release(output);
+			QMetaObject::invokeMethod(this, "OnVirtualCamStop");
+			return;
+		}
 	} else if (virtual_cam_mode == VIRTUAL_CAMERA_BOTH) {
 		if (!multiCanvasView) {
 			multiCanvasView = obs_view_create();
 		}
-		started_view = multiCanvasView;
 		if (!multiCanvasSource) {
 			multiCanvasSource =
 				obs_source_create_private("vertical_multi_canvas_source", "vertical_multi_canvas_source", nullptr);
 			void *data = obs_obj_get_data(multiCanvasSource);
 			multi_canvas_source_add_view(data, view, canvas_width, canvas_height);
+			multi_canvas_source_set_metrics(data, metrics.GetRing(CanvasMetric::MultiCanvasRender));
 		}
 		if (!multiCanvasVideo) {
 			obs_video_info ovi;
@@ -4705,7 +4841,6 @@ void CanvasDock::StartVirtualCam()
 			ovi.output_width = ovi.base_width;
 			ovi.output_height = ovi.base_height;
 			multiCanvasVideo = obs_view_add2(multiCanvasView, &ovi);
-			started_video = true;
 		}
 		virtual_video = multiCanvasVideo;
 		if (obs_view_get_source(multiCanvasView, 0) != multiCanvasSource)
@@ -4720,21 +4855,11 @@ void CanvasDock::StartVirtualCam()
 	signal_handler_connect(signal, "stop", virtual_cam_output_stop, this);
 
 	obs_output_set_media(output, virtual_video, obs_get_audio());
-	SendVendorEvent("virtual_camera_starting");
+	SendVendorEvent("virtual_camera_starting", VENDOR_EVENT_VIRTUAL_CAMERA);
 	const bool success = obs_output_start(output);
 	if (!success) {
+		// releases the vertical video mix and tears down the multi canvas view
 		QMetaObject::invokeMethod(this, "OnVirtualCamStop");
-		if (started_video) {
-			obs_view_remove(started_view);
-			obs_view_set_source(started_view, 0, nullptr);
-			if (video == virtual_video) {
-				video = nullptr;
-			} else if (multiCanvasVideo == virtual_video) {
-				multiCanvasVideo = nullptr;
-				obs_view_destroy(started_view);
-				multiCanvasView = nullptr;
-			}
-		}
 	}
 }
 
@@ -4744,7 +4869,7 @@ void CanvasDock::StopVirtualCam()
 		virtualCamButton->setChecked(false);
 		return;
 	}
-	SendVendorEvent("virtual_camera_stopping");
+	SendVendorEvent("virtual_camera_stopping", VENDOR_EVENT_VIRTUAL_CAMERA);
 	if (obs_output_video(virtualCamOutput) != obs_get_video())
 		obs_output_set_media(virtualCamOutput, nullptr, nullptr);
 	obs_output_stop(virtualCamOutput);
@@ -4763,6 +4888,33 @@ void CanvasDock::ConfigButtonClicked()
 
 void CanvasDock::ReplayButtonClicked(QString filename)
 {
+	if (diskBacktrack && diskBacktrack->Active()) {
+		std::string format = filename.isEmpty() ? replayFilename : std::string(filename.toUtf8().constData());
+		char *name = os_generate_formatted_filename("ts", true, format.c_str());
+		std::string path = replayPath + "/" + name;
+		bfree(name);
+		auto progress = [this](int percent) {
+			QMetaObject::invokeMethod(this, [this, percent] {
+				statusLabel->setText(QString::fromUtf8(obs_module_text("Saving")) + QString::fromUtf8(" %1%").arg(percent));
+				replayStatusResetTimer.start(10000);
+			});
+		};
+		auto saved = [this](bool success, std::string saved_path) {
+			if (!success)
+				return;
+			// runs on the saver thread, the dock is only touched from its own thread
+			QMetaObject::invokeMethod(this, [this, saved_path] {
+				SendVendorEvent("backtrack_saved", VENDOR_EVENT_BACKTRACK);
+				OnReplaySaved(QString::fromUtf8(saved_path.c_str()));
+			});
+		};
+		if (!diskBacktrack->Save(path, progress, saved))
+			return;
+		statusLabel->setText(QString::fromUtf8(obs_module_text("Saving")));
+		replayStatusResetTimer.start(10000);
+		SendVendorEvent("backtrack_saving", VENDOR_EVENT_BACKTRACK);
+		return;
+	}
 	if (!obs_output_active(replayOutput))
 		return;
 	obs_data_t *s = obs_output_get_settings(replayOutput);
@@ -4781,7 +4933,7 @@ void CanvasDock::ReplayButtonClicked(QString filename)
 
 	statusLabel->setText(QString::fromUtf8(obs_module_text("Saving")));
 	replayStatusResetTimer.start(10000);
-	SendVendorEvent("backtrack_saving");
+	SendVendorEvent("backtrack_saving", VENDOR_EVENT_BACKTRACK);
 }
 
 int GetConfigPath(char *path, size_t size, const char *name)
@@ -4801,50 +4953,6 @@ int GetConfigPath(char *path, size_t size, const char *name)
 #endif
 }
 
-static inline int GetProfilePath(char *path, size_t size, const char *file)
-{
-	char profiles_path[512];
-	config_t *config = obs_frontend_get_global_config();
-	if (!config)
-		return -1;
-	const char *profile = config_get_string(config, "Basic", "ProfileDir");
-
-	if (!profile)
-		return -1;
-	if (!path)
-		return -1;
-	if (!file)
-		file = "";
-
-	int ret = GetConfigPath(profiles_path, 512, "obs-studio/basic/profiles");
-	if (ret <= 0)
-		return ret;
-
-	if (!*file)
-		return snprintf(path, size, "%s/%s", profiles_path, profile);
-
-	return snprintf(path, size, "%s/%s/%s", profiles_path, profile, file);
-}
-
-static obs_data_t *GetDataFromJsonFile(const char *jsonFile)
-{
-	char fullPath[512];
-	obs_data_t *data = nullptr;
-
-	int ret = GetProfilePath(fullPath, sizeof(fullPath), jsonFile);
-	if (ret > 0) {
-		BPtr<char> jsonData = os_quick_read_utf8_file(fullPath);
-		if (!!jsonData) {
-			data = obs_data_create_from_json(jsonData);
-		}
-	}
-
-	if (!data)
-		data = obs_data_create();
-
-	return data;
-}
-
 void CanvasDock::RecordButtonClicked()
 {
 	if (obs_output_active(recordOutput)) {
@@ -4933,7 +5041,10 @@ void CanvasDock::StartRecord()
 		return;
 	}
 
-	const bool started_video = StartVideo();
+	if (!AcquireVideo(VIDEO_CONSUMER_RECORD)) {
+		QMetaObject::invokeMethod(this, "OnRecordStop", Q_ARG(int, OBS_OUTPUT_ERROR), Q_ARG(QString, QString()));
+		return;
+	}
 
 	obs_output_set_video_encoder(recordOutput, GetRecordVideoEncoder());
 
@@ -4991,16 +5102,11 @@ void CanvasDock::StartRecord()
 
 	obs_output_set_media(recordOutput, video, obs_get_audio());
 
-	SendVendorEvent("recording_starting");
+	SendVendorEvent("recording_starting", VENDOR_EVENT_RECORDING);
 	const bool success = obs_output_start(recordOutput);
 	if (!success) {
 		QMetaObject::invokeMethod(this, "OnRecordStop", Q_ARG(int, OBS_OUTPUT_ERROR),
 					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(recordOutput))));
-		if (started_video) {
-			video = nullptr;
-			obs_view_remove(view);
-			obs_view_set_source(view, 0, nullptr);
-		}
 	}
 }
 
@@ -5008,7 +5114,7 @@ void CanvasDock::StopRecord()
 {
 	recordButton->setChecked(false);
 	if (obs_output_active(recordOutput)) {
-		SendVendorEvent("recording_stopping");
+		SendVendorEvent("recording_stopping", VENDOR_EVENT_RECORDING);
 		obs_output_stop(recordOutput);
 	}
 }
@@ -5017,7 +5123,7 @@ void CanvasDock::record_output_start(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("recording_started");
+	d->SendVendorEvent("recording_started", VENDOR_EVENT_RECORDING, d->recordOutput);
 	d->StartReplayBuffer();
 	QMetaObject::invokeMethod(d, "OnRecordStart");
 }
@@ -5028,7 +5134,7 @@ void CanvasDock::record_output_stop(void *data, calldata_t *calldata)
 	QString arg_last_error = QString::fromUtf8(last_error);
 	const int code = (int)calldata_int(calldata, "code");
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("recording_stopped");
+	d->SendVendorEvent("recording_stopped", VENDOR_EVENT_RECORDING, d->recordOutput, code, last_error);
 	QMetaObject::invokeMethod(d, "OnRecordStop", Q_ARG(int, code), Q_ARG(QString, arg_last_error));
 }
 
@@ -5043,7 +5149,7 @@ void CanvasDock::replay_saved(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("backtrack_saved");
+	d->SendVendorEvent("backtrack_saved", VENDOR_EVENT_BACKTRACK);
 	QMetaObject::invokeMethod(d, "OnReplaySaved");
 }
 
@@ -5055,7 +5161,7 @@ void CanvasDock::SetRecordAudioEncoders(obs_output_t *output)
 		for (size_t i = 0; i < MAX_AUDIO_MIXES; i++) {
 			if ((record_audio_tracks & (1ll << i)) == 0)
 				continue;
-			obs_encoder_t *aet = obs_output_get_audio_encoder(replayOutput, idx);
+			obs_encoder_t *aet = replayOutput ? obs_output_get_audio_encoder(replayOutput, idx) : nullptr;
 			if (!aet && recordOutput)
 				aet = obs_output_get_audio_encoder(recordOutput, idx);
 			if (aet && strcmp(obs_encoder_get_id(aet), "ffmpeg_aac") != 0)
@@ -5070,77 +5176,29 @@ void CanvasDock::SetRecordAudioEncoders(obs_output_t *output)
 			idx++;
 		}
 	} else {
-		bool r = false;
-		obs_output_t *main_output = obs_frontend_get_replay_buffer_output();
-		if (!main_output) {
-			r = true;
-			main_output = obs_frontend_get_recording_output();
-		}
-		size_t mixers = obs_output_get_mixers(main_output);
-		if (!mixers) {
-			obs_output_t *record_output = obs_frontend_get_recording_output();
-			if (record_output) {
-				mixers = obs_output_get_mixers(record_output);
-				obs_output_release(record_output);
-			}
-			if (!mixers) {
-				config_t *config = obs_frontend_get_profile_config();
-				const char *mode = config_get_string(config, "Output", "Mode");
-				if (astrcmpi(mode, "Advanced") == 0) {
-					const char *recType = config_get_string(config, "AdvOut", "RecType");
-					if (astrcmpi(recType, "FFmpeg") == 0) {
-						mixers = config_get_int(config, "AdvOut", "FFAudioMixes");
-					} else {
-						mixers = config_get_int(config, "AdvOut", "RecTracks");
-					}
-
-				} else {
-					const char *quality = config_get_string(config, "SimpleOutput", "RecQuality");
-					if (strcmp(quality, "Stream") == 0) {
-						mixers = 1;
-					} else {
-						mixers = config_get_int(config, "SimpleOutput", "RecTracks");
-					}
-				}
-				if (!mixers)
-					mixers = 1;
-			}
-		}
+		const uint32_t mixers = EncoderResolver::GetRecordMixers();
 		obs_output_set_mixers(output, mixers);
 		for (size_t i = 0; i < MAX_AUDIO_MIXES; i++) {
 			if ((mixers & (1ll << i)) == 0)
 				continue;
-			obs_encoder_t *aef = obs_output_get_audio_encoder(main_output, idx);
-			if (!aef && idx == 0) {
-				if (r) {
-					obs_frontend_recording_start();
-					obs_frontend_recording_stop();
-				} else {
-					obs_frontend_replay_buffer_start();
-					obs_frontend_replay_buffer_stop();
-				}
-				aef = obs_output_get_audio_encoder(main_output, idx);
-			}
-			if (aef) {
-				obs_encoder_t *aet = obs_output_get_audio_encoder(replayOutput, idx);
-				if (!aet && recordOutput)
-					aet = obs_output_get_audio_encoder(recordOutput, idx);
-				if (aet && strcmp(obs_encoder_get_id(aef), obs_encoder_get_id(aet)) != 0)
-					aet = nullptr;
-				if (!aet) {
-					std::string name = obs_encoder_get_name(aef);
-					name += "_vertical";
-					aet = obs_audio_encoder_create(obs_encoder_get_id(aef), name.c_str(), nullptr, i, nullptr);
-					obs_encoder_set_audio(aet, obs_get_audio());
-				}
-				auto s = obs_encoder_get_settings(aef);
-				obs_encoder_update(aet, s);
-				obs_data_release(s);
-				obs_output_set_audio_encoder(output, aet, idx);
-				idx++;
+			std::string enc_id;
+			obs_data_t *s = EncoderResolver::GetRecordAudio(enc_id, i);
+			obs_encoder_t *aet = replayOutput ? obs_output_get_audio_encoder(replayOutput, idx) : nullptr;
+			if (!aet && recordOutput)
+				aet = obs_output_get_audio_encoder(recordOutput, idx);
+			if (aet && strcmp(enc_id.c_str(), obs_encoder_get_id(aet)) != 0)
+				aet = nullptr;
+			if (!aet) {
+				std::string name = "vertical_canvas_record_audio_encoder";
+				name += std::to_string(idx);
+				aet = obs_audio_encoder_create(enc_id.c_str(), name.c_str(), nullptr, i, nullptr);
+				obs_encoder_set_audio(aet, obs_get_audio());
 			}
+			obs_encoder_update(aet, s);
+			obs_data_release(s);
+			obs_output_set_audio_encoder(output, aet, idx);
+			idx++;
 		}
-		obs_output_release(main_output);
 	}
 	for (; idx < MAX_AUDIO_MIXES; idx++) {
 		obs_output_set_audio_encoder(output, nullptr, idx);
@@ -5169,52 +5227,112 @@ void CanvasDock::ShowNoReplayOutputError()
 	}
 }
 
+uint32_t CanvasDock::backtrack_budget_mb = 0;
+
+uint32_t CanvasDock::GetReplayMaxSize()
+{
+	if (!backtrack_budget_mb)
+		return replayMaxSize;
+
+	// split the shared budget by the expected size of each backtrack window,
+	// disk backtracks keep their window out of memory
+	uint64_t total = 0;
+	uint64_t own = 0;
+	for (const auto &it : canvas_docks) {
+		if ((!it->startReplay && !it->replayAlwaysOn) || it->replayDisk)
+			continue;
+		uint64_t weight = (uint64_t)((it->recordVideoBitrate ? it->recordVideoBitrate : 6000) +
+					     (it->audioBitrate ? it->audioBitrate : 160)) *
+				  (it->replayDuration ? it->replayDuration : 5);
+		total += weight;
+		if (it == this)
+			own = weight;
+	}
+	if (!total || !own)
+		return replayMaxSize;
+	uint32_t share = (uint32_t)(backtrack_budget_mb * own / total);
+	if (!share)
+		share = 1;
+	if (replayMaxSize && replayMaxSize < share)
+		return replayMaxSize;
+	return share;
+}
+
+void CanvasDock::SetBacktrackBudget(uint32_t budget_mb)
+{
+	if (backtrack_budget_mb != budget_mb) {
+		blog(LOG_INFO, "[Vertical Canvas] backtrack memory budget changed from %u MB to %u MB", backtrack_budget_mb,
+		     budget_mb);
+		backtrack_budget_mb = budget_mb;
+	}
+	UpdateBacktrackShares();
+}
+
+void CanvasDock::UpdateBacktrackShares()
+{
+	// the replay buffer reads max_size_mb only when it starts, restarting it would drop
+	// the buffered window, so a running backtrack keeps its limit until its next start
+	for (const auto &it : canvas_docks) {
+		if (it->replayDisk || !obs_output_active(it->replayOutput))
+			continue;
+		obs_data_t *s = obs_output_get_settings(it->replayOutput);
+		const uint32_t current = (uint32_t)obs_data_get_int(s, "max_size_mb");
+		obs_data_release(s);
+		const uint32_t share = it->GetReplayMaxSize();
+		if (share != current)
+			blog(LOG_INFO, "[Vertical Canvas] backtrack share of %s changed from %u MB to %u MB on the next start",
+			     it->canvas_id.c_str(), current, share);
+	}
+}
+
+// the replay buffer muxes a clip in one go when it is saved, so it can write
+// the container the frontend would auto remux to instead of remuxing afterwards
+static const char *backtrack_extension(const char *extension)
+{
+	if (!extension || !*extension || !config_get_bool(obs_frontend_get_profile_config(), "Video", "AutoRemux"))
+		return extension;
+	if (astrcmpi(extension, "mp4") == 0 || astrcmpi(extension, "mov") == 0 || astrcmpi(extension, "avi") == 0)
+		return extension;
+	return "mp4";
+}
+
 void CanvasDock::StartReplayBuffer()
 {
 	if ((!startReplay && !replayAlwaysOn) || obs_output_active(replayOutput))
 		return;
 
+	// also for the disk backtrack, the save hotkey lives on the replay output
+	EnsureReplayOutput();
+	if (replayDisk) {
+		StartDiskBacktrack();
+		return;
+	}
+	// this backtrack joins the budget, the running ones get a smaller share from their next start
+	UpdateBacktrackShares();
+
 	if (record_advanced_settings) {
 		if (!replayDuration)
 			replayDuration = 5;
 		auto s = obs_data_create();
 		obs_data_set_int(s, "max_time_sec", replayDuration);
-		obs_data_set_int(s, "max_size_mb", 0);
+		obs_data_set_int(s, "max_size_mb", GetReplayMaxSize());
 		if (filename_formatting.empty())
 			filename_formatting = "%CCYY-%MM-%DD %hh-%mm-%ss";
 		obs_data_set_string(s, "format", filename_formatting.c_str());
 		replayFilename = filename_formatting;
 		if (file_format.empty())
 			file_format = "mkv";
-		obs_data_set_string(s, "extension", file_format.c_str());
+		obs_data_set_string(s, "extension", backtrack_extension(file_format.c_str()));
 		//allow_spaces
 		obs_data_set_string(s, "directory", replayPath.c_str());
 		obs_output_update(replayOutput, s);
 		obs_data_release(s);
 	} else {
-		obs_output_t *replay_output = obs_frontend_get_replay_buffer_output();
-		if (!replay_output) {
+		auto settings = EncoderResolver::GetReplaySettings();
+		if (!settings) {
 			ShowNoReplayOutputError();
 			return;
 		}
-		obs_encoder_t *enc = obs_output_get_video_encoder(replay_output);
-		if (!enc) {
-			obs_frontend_replay_buffer_start();
-			obs_frontend_replay_buffer_stop();
-			enc = obs_output_get_video_encoder(replay_output);
-		}
-		if (!enc) {
-			obs_output_release(replay_output);
-			blog(LOG_WARNING, "[Vertical Canvas] error starting backtrack: no video encoder found");
-			return;
-		}
-
-		auto settings = obs_output_get_settings(replay_output);
-		obs_output_release(replay_output);
-		if (!strlen(obs_data_get_string(settings, "directory"))) {
-			obs_frontend_replay_buffer_start();
-			obs_frontend_replay_buffer_stop();
-		}
 		if (!replayDuration) {
 			replayDuration = obs_data_get_int(settings, "max_time_sec");
 			if (!replayDuration)
@@ -5228,9 +5346,10 @@ void CanvasDock::StartReplayBuffer()
 			obs_data_set_int(s, "max_time_sec", replayDuration);
 			obs_data_release(s);
 		}
-		if (obs_data_get_int(settings, "max_size_mb")) {
+		const uint32_t max_size = GetReplayMaxSize();
+		if (obs_data_get_int(settings, "max_size_mb") != max_size) {
 			const auto s = obs_output_get_settings(replayOutput);
-			obs_data_set_int(s, "max_size_mb", 0);
+			obs_data_set_int(s, "max_size_mb", max_size);
 			obs_data_release(s);
 		}
 		if (strcmp(replayPath.c_str(), obs_data_get_string(settings, "directory")) != 0) {
@@ -5260,13 +5379,23 @@ void CanvasDock::StartReplayBuffer()
 			obs_data_set_string(s, "format", format.c_str());
 			obs_data_release(s);
 		}
+		const char *extension = obs_data_get_string(settings, "extension");
+		const char *final_extension = backtrack_extension(extension);
+		if (final_extension != extension) {
+			const auto s = obs_output_get_settings(replayOutput);
+			obs_data_set_string(s, "extension", final_extension);
+			obs_data_release(s);
+		}
 		obs_data_release(settings);
 		obs_output_update(replayOutput, nullptr);
 	}
 
 	SetRecordAudioEncoders(replayOutput);
 
-	bool started_video = StartVideo();
+	if (!AcquireVideo(VIDEO_CONSUMER_BACKTRACK)) {
+		QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_ERROR), Q_ARG(QString, QString()));
+		return;
+	}
 
 	obs_output_set_video_encoder(replayOutput, GetRecordVideoEncoder());
 
@@ -5277,76 +5406,18 @@ void CanvasDock::StartReplayBuffer()
 	signal_handler_connect(signal, "stop", replay_output_stop, this);
 
 	obs_output_set_media(replayOutput, video, obs_get_audio());
-	SendVendorEvent("backtrack_starting");
+	SendVendorEvent("backtrack_starting", VENDOR_EVENT_BACKTRACK);
 
 	const bool success = obs_output_start(replayOutput);
 	if (!success) {
 		QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_ERROR),
 					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(replayOutput))));
-		if (started_video) {
-			video = nullptr;
-			obs_view_remove(view);
-			obs_view_set_source(view, 0, nullptr);
-		}
+		ReleaseVideo(VIDEO_CONSUMER_BACKTRACK);
 	} else {
 		QMetaObject::invokeMethod(this, "OnReplayBufferStart");
 	}
 }
 
-#define SIMPLE_ENCODER_X264 "x264"
-#define SIMPLE_ENCODER_X264_LOWCPU "x264_lowcpu"
-#define SIMPLE_ENCODER_QSV "qsv"
-#define SIMPLE_ENCODER_QSV_AV1 "qsv_av1"
-#define SIMPLE_ENCODER_NVENC "nvenc"
-#define SIMPLE_ENCODER_NVENC_AV1 "nvenc_av1"
-#define SIMPLE_ENCODER_NVENC_HEVC "nvenc_hevc"
-#define SIMPLE_ENCODER_AMD "amd"
-#define SIMPLE_ENCODER_AMD_HEVC "amd_hevc"
-#define SIMPLE_ENCODER_AMD_AV1 "amd_av1"
-#define SIMPLE_ENCODER_APPLE_H264 "apple_h264"
-#define SIMPLE_ENCODER_APPLE_HEVC "apple_hevc"
-
-bool EncoderAvailable(const char *encoder)
-{
-	const char *val;
-	int i = 0;
-
-	while (obs_enum_encoder_types(i++, &val))
-		if (strcmp(val, encoder) == 0)
-			return true;
-
-	return false;
-}
-
-const char *get_simple_output_encoder(const char *encoder)
-{
-	if (strcmp(encoder, SIMPLE_ENCODER_X264) == 0)
-		return "obs_x264";
-	if (strcmp(encoder, SIMPLE_ENCODER_X264_LOWCPU) == 0)
-		return "obs_x264";
-	if (strcmp(encoder, SIMPLE_ENCODER_QSV) == 0)
-		return "obs_qsv11_v2";
-	if (strcmp(encoder, SIMPLE_ENCODER_QSV_AV1) == 0)
-		return "obs_qsv11_av1";
-	if (strcmp(encoder, SIMPLE_ENCODER_AMD) == 0)
-		return "h264_texture_amf";
-	if (strcmp(encoder, SIMPLE_ENCODER_AMD_HEVC) == 0)
-		return "h265_texture_amf";
-	if (strcmp(encoder, SIMPLE_ENCODER_AMD_AV1) == 0)
-		return "av1_texture_amf";
-	if (strcmp(encoder, SIMPLE_ENCODER_NVENC) == 0)
-		return EncoderAvailable("jim_nvenc") ? "jim_nvenc" : "ffmpeg_nvenc";
-	if (strcmp(encoder, SIMPLE_ENCODER_NVENC_HEVC) == 0)
-		return EncoderAvailable("jim_hevc_nvenc") ? "jim_hevc_nvenc" : "ffmpeg_hevc_nvenc";
-	if (strcmp(encoder, SIMPLE_ENCODER_NVENC_AV1) == 0)
-		return "jim_av1_nvenc";
-	if (strcmp(encoder, SIMPLE_ENCODER_APPLE_H264) == 0)
-		return "com.apple.videotoolbox.videoencoder.ave.avc";
-	if (strcmp(encoder, SIMPLE_ENCODER_APPLE_HEVC) == 0)
-		return "com.apple.videotoolbox.videoencoder.ave.hevc";
-	return "obs_x264";
-}
-
 obs_encoder_t *CanvasDock::GetStreamVideoEncoder()
 {
 	obs_encoder_t *video_encoder = nullptr;
@@ -5373,7 +5444,7 @@ obs_encoder_t *CanvasDock::GetStreamVideoEncoder()
 			}
 		}
 	} else if (strcmp(mode, "Advanced") == 0) {
-		video_settings = GetDataFromJsonFile("streamEncoder.json");
+		video_settings = EncoderResolver::GetStreamEncoderSettings();
 		enc_id = config_get_string(config, "AdvOut", "Encoder");
 		const char *recordEncoder = config_get_string(config, "AdvOut", "RecEncoder");
 		useRecordEncoder = astrcmpi(recordEncoder, "none") == 0;
@@ -5385,36 +5456,10 @@ obs_encoder_t *CanvasDock::GetStreamVideoEncoder()
 	} else {
 		video_settings = obs_data_create();
 		bool advanced = config_get_bool(config, "SimpleOutput", "UseAdvanced");
-		enc_id = get_simple_output_encoder(config_get_string(config, "SimpleOutput", "StreamEncoder"));
-		const char *presetType;
+		const char *simpleEncoder = config_get_string(config, "SimpleOutput", "StreamEncoder");
+		enc_id = get_simple_output_encoder(simpleEncoder);
+		const char *presetType = get_simple_output_preset_type(simpleEncoder);
 		const char *preset;
-		if (strcmp(enc_id, SIMPLE_ENCODER_QSV) == 0) {
-			presetType = "QSVPreset";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_QSV_AV1) == 0) {
-			presetType = "QSVPreset";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_AMD) == 0) {
-			presetType = "AMDPreset";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_AMD_HEVC) == 0) {
-			presetType = "AMDPreset";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_NVENC) == 0) {
-			presetType = "NVENCPreset2";
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_NVENC_HEVC) == 0) {
-			presetType = "NVENCPreset2";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_AMD_AV1) == 0) {
-			presetType = "AMDAV1Preset";
-
-		} else if (strcmp(enc_id, SIMPLE_ENCODER_NVENC_AV1) == 0) {
-			presetType = "NVENCPreset2";
-
-		} else {
-			presetType = "Preset";
-		}
-
 		preset = config_get_string(config, "SimpleOutput", presetType);
 		obs_data_set_string(video_settings, (strcmp(presetType, "NVENCPreset2") == 0) ? "preset2" : "preset", preset);
 
@@ -5475,8 +5520,12 @@ obs_encoder_t *CanvasDock::GetStreamVideoEncoder()
 	default:
 		obs_encoder_set_preferred_video_format(video_encoder, VIDEO_FORMAT_NV12);
 	}
-	if (!obs_encoder_active(video_encoder))
+	if (!obs_encoder_active(video_encoder)) {
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(30, 2, 0)
+		obs_encoder_set_frame_rate_divisor(video_encoder, fps_divisor);
+#endif
 		obs_encoder_set_video(video_encoder, video);
+	}
 	return video_encoder;
 }
 
@@ -5485,6 +5534,7 @@ obs_encoder_t *CanvasDock::GetRecordVideoEncoder()
 	obs_encoder_t *video_encoder = nullptr;
 	const char *enc_id = nullptr;
 	obs_data_t *settings = nullptr;
+	std::string resolved_id;
 	if (record_advanced_settings) {
 		if (record_encoder.empty()) {
 			return GetStreamVideoEncoder();
@@ -5494,17 +5544,13 @@ obs_encoder_t *CanvasDock::GetRecordVideoEncoder()
 			obs_data_addref(settings);
 		}
 	} else {
-		config_t *config = obs_frontend_get_profile_config();
-		const char *mode = config_get_string(config, "Output", "Mode");
-		if (strcmp(mode, "Advanced") == 0) {
-			if (astrcmpi(config_get_string(config, "AdvOut", "RecEncoder"), "none") == 0)
-				return GetStreamVideoEncoder();
-			enc_id = config_get_string(config, "AdvOut", "RecEncoder");
-		} else {
-			if (strcmp(config_get_string(config, "SimpleOutput", "RecQuality"), "Stream") == 0)
-				return GetStreamVideoEncoder();
-			enc_id = get_simple_output_encoder(config_get_string(config, "SimpleOutput", "RecEncoder"));
-		}
+		if (!EncoderResolver::GetRecordVideo(resolved_id, &settings, canvas_width, canvas_height))
+			return GetStreamVideoEncoder();
+		enc_id = resolved_id.c_str();
+		if (!recordVideoBitrate)
+			recordVideoBitrate = (uint32_t)obs_data_get_int(settings, "bitrate");
+		else
+			obs_data_set_int(settings, "bitrate", recordVideoBitrate);
 	}
 
 	if (!video_encoder && replayOutput) {
@@ -5526,27 +5572,6 @@ obs_encoder_t *CanvasDock::GetRecordVideoEncoder()
 	obs_encoder_update(video_encoder, settings);
 	obs_data_release(settings);
 
-	if (!record_advanced_settings) {
-		obs_output_t *main_output = obs_frontend_get_replay_buffer_output();
-		if (!main_output)
-			main_output = obs_frontend_get_recording_output();
-		auto enc = obs_output_get_video_encoder(main_output);
-		obs_output_release(main_output);
-		obs_data_t *d = obs_encoder_get_settings(enc);
-		obs_encoder_update(video_encoder, d);
-		if (!recordVideoBitrate) {
-			recordVideoBitrate = (uint32_t)obs_data_get_int(d, "bitrate");
-		} else {
-			auto s = obs_encoder_get_settings(video_encoder);
-			if (recordVideoBitrate != obs_data_get_int(s, "bitrate")) {
-				obs_data_set_int(s, "bitrate", recordVideoBitrate);
-				obs_encoder_update(video_encoder, nullptr);
-			}
-			obs_data_release(s);
-		}
-		obs_data_release(d);
-	}
-
 	switch (video_output_get_format(video)) {
 	case VIDEO_FORMAT_I420:
 	case VIDEO_FORMAT_NV12:
@@ -5556,8 +5581,12 @@ obs_encoder_t *CanvasDock::GetRecordVideoEncoder()
 	default:
 		obs_encoder_set_preferred_video_format(video_encoder, VIDEO_FORMAT_NV12);
 	}
-	if (!obs_encoder_active(video_encoder))
+	if (!obs_encoder_active(video_encoder)) {
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(30, 2, 0)
+		obs_encoder_set_frame_rate_divisor(video_encoder, fps_divisor);
+#endif
 		obs_encoder_set_video(video_encoder, video);
+	}
 	return video_encoder;
 }
 
@@ -5566,9 +5595,76 @@ void CanvasDock::StopReplayBuffer()
 	QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_SUCCESS),
 				  Q_ARG(QString, QString::fromUtf8("")));
 	if (obs_output_active(replayOutput)) {
-		SendVendorEvent("backtrack_stopping");
+		SendVendorEvent("backtrack_stopping", VENDOR_EVENT_BACKTRACK);
 		obs_output_stop(replayOutput);
 	}
+	if (diskBacktrack && diskBacktrack->Active()) {
+		SendVendorEvent("backtrack_stopping", VENDOR_EVENT_BACKTRACK);
+		diskBacktrack->Stop();
+	}
+}
+
+void CanvasDock::StartDiskBacktrack()
+{
+	if (!diskBacktrack) {
+		char *spool = obs_module_config_path("backtrack");
+		std::string dir = spool;
+		bfree(spool);
+		// one spool per canvas, starting a backtrack clears its spool
+		dir += "/" + canvas_id;
+		const QString name = QString::fromUtf8(obs_module_text("Vertical")) + " " +
+				     QString::fromUtf8(obs_module_text("Backtrack")) + " Disk";
+		diskBacktrack = std::make_unique<DiskBacktrack>(name.toUtf8().constData(), dir);
+	}
+	if (diskBacktrack->Active())
+		return;
+	if (replayPath.empty()) {
+		auto settings = EncoderResolver::GetReplaySettings();
+		if (settings) {
+			replayPath = obs_data_get_string(settings, "directory");
+			obs_data_release(settings);
+		}
+	}
+	if (!replayDuration)
+		replayDuration = 5;
+	replayFilename = filename_formatting.empty() ? "%CCYY-%MM-%DD %hh-%mm-%ss-backtrack" : filename_formatting;
+
+	obs_output_t *output = diskBacktrack->GetOutput();
+	SetRecordAudioEncoders(output);
+
+	if (!AcquireVideo(VIDEO_CONSUMER_BACKTRACK)) {
+		QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_ERROR), Q_ARG(QString, QString()));
+		return;
+	}
+
+	obs_output_set_video_encoder(output, GetRecordVideoEncoder());
+
+	signal_handler_t *signal = obs_output_get_signal_handler(output);
+	signal_handler_disconnect(signal, "start", replay_output_start, this);
+	signal_handler_disconnect(signal, "stop", replay_output_stop, this);
+	signal_handler_connect(signal, "start", replay_output_start, this);
+	signal_handler_connect(signal, "stop", replay_output_stop, this);
+
+	obs_output_set_media(output, video, obs_get_audio());
+	SendVendorEvent("backtrack_starting", VENDOR_EVENT_BACKTRACK);
+
+	if (!diskBacktrack->Start(replayDuration)) {
+		QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_ERROR),
+					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(output))));
+		ReleaseVideo(VIDEO_CONSUMER_BACKTRACK);
+	} else {
+		QMetaObject::invokeMethod(this, "OnReplayBufferStart");
+	}
+}
+
+void CanvasDock::save_backtrack_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	if (!pressed)
+		return;
+	auto d = static_cast<CanvasDock *>(data);
+	QMetaObject::invokeMethod(d, "ReplayButtonClicked", Qt::QueuedConnection, Q_ARG(QString, QString()));
 }
 
 void CanvasDock::replay_output_start(void *data, calldata_t *calldata)
@@ -5576,7 +5672,7 @@ void CanvasDock::replay_output_start(void *data, calldata_t *calldata)
 	UNUSED_PARAMETER(calldata);
 	UNUSED_PARAMETER(data);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("backtrack_started");
+	d->SendVendorEvent("backtrack_started", VENDOR_EVENT_BACKTRACK);
 	QMetaObject::invokeMethod(d, "OnReplayBufferStart");
 }
 
@@ -5586,7 +5682,9 @@ void CanvasDock::replay_output_stop(void *data, calldata_t *calldata)
 	QString arg_last_error = QString::fromUtf8(last_error);
 	const int code = (int)calldata_int(calldata, "code");
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("backtrack_stopped");
+	d->SendVendorEvent("backtrack_stopped", VENDOR_EVENT_BACKTRACK, (obs_output_t *)calldata_ptr(calldata, "output"), code,
+			   last_error);
+	QMetaObject::invokeMethod(d, [d] { d->ReleaseVideo(VIDEO_CONSUMER_BACKTRACK); }, Qt::QueuedConnection);
 	QMetaObject::invokeMethod(d, "OnReplayBufferStop", Q_ARG(int, code), Q_ARG(QString, arg_last_error));
 }
 
@@ -5644,8 +5742,19 @@ void CanvasDock::StreamButtonMultiMenu(QMenu *menu)
 	}
 }
 
+void CanvasDock::EnsureStreamService(std::vector<StreamServer>::iterator it)
+{
+	// services are created when a stream starts, not for every configured server at startup
+	if (it->service)
+		return;
+	std::string service_name = "vertical_canvas_stream_service_";
+	service_name += std::to_string(it - streamOutputs.begin());
+	it->service = obs_service_create("rtmp_custom", service_name.c_str(), nullptr, nullptr);
+}
+
 void CanvasDock::CreateStreamOutput(std::vector<StreamServer>::iterator it)
 {
+	EnsureStreamService(it);
 	auto s = obs_data_create();
 	obs_data_set_string(s, "server", it->stream_server.c_str());
 	obs_data_set_string(s, "key", it->stream_key.c_str());
@@ -5804,10 +5913,15 @@ void CanvasDock::StartStream()
 		return;
 	}
 
-	const bool started_video = StartVideo();
+	if (!AcquireVideo(VIDEO_CONSUMER_STREAM)) {
+		QMetaObject::invokeMethod(this, "OnStreamStop", Q_ARG(int, OBS_OUTPUT_ERROR), Q_ARG(QString, QString()),
+					  Q_ARG(QString, QString()), Q_ARG(QString, QString()));
+		return;
+	}
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (!it->enabled)
 			continue;
+		EnsureStreamService(it);
 		auto s = obs_data_create();
 		obs_data_set_string(s, "server", it->stream_server.c_str());
 		obs_data_set_string(s, "key", it->stream_key.c_str());
@@ -5827,7 +5941,7 @@ void CanvasDock::StartStream()
 		obs_output_set_audio_encoder(it->output, audio_encoder, 0);
 	}
 
-	SendVendorEvent("streaming_starting");
+	SendVendorEvent("streaming_starting", VENDOR_EVENT_STREAMING);
 
 	config_t *config = obs_frontend_get_profile_config();
 	bool success = false;
@@ -5849,11 +5963,8 @@ void CanvasDock::StartStream()
 						  Q_ARG(QString, QString::fromUtf8(it->stream_server)),
 						  Q_ARG(QString, QString::fromUtf8(it->stream_key)));
 	}
-	if (!success && started_video) {
-		video = nullptr;
-		obs_view_remove(view);
-		obs_view_set_source(view, 0, nullptr);
-	}
+	if (!success)
+		ReleaseVideo(VIDEO_CONSUMER_STREAM);
 }
 
 void CanvasDock::StopStream()
@@ -5867,15 +5978,14 @@ void CanvasDock::StopStream()
 		}
 	}
 	if (done)
-		SendVendorEvent("streaming_stopping");
+		SendVendorEvent("streaming_stopping", VENDOR_EVENT_STREAMING);
 	CheckReplayBuffer();
 }
 
 void CanvasDock::stream_output_start(void *data, calldata_t *calldata)
 {
-	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("streaming_started");
+	d->SendVendorEvent("streaming_started", VENDOR_EVENT_STREAMING, (obs_output_t *)calldata_ptr(calldata, "output"));
 	d->StartReplayBuffer();
 	QMetaObject::invokeMethod(d, "OnStreamStart");
 }
@@ -5886,10 +5996,10 @@ void CanvasDock::stream_output_stop(void *data, calldata_t *calldata)
 	QString arg_last_error = QString::fromUtf8(last_error);
 	const int code = (int)calldata_int(calldata, "code");
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("streaming_stopped");
 	QString stream_server;
 	QString stream_key;
 	obs_output_t *t = (obs_output_t *)calldata_ptr(calldata, "output");
+	d->SendVendorEvent("streaming_stopped", VENDOR_EVENT_STREAMING, t, code, last_error);
 	for (auto it = d->streamOutputs.begin(); it != d->streamOutputs.end(); ++it) {
 		if (it->output == t) {
 			stream_server = QString::fromUtf8(it->stream_server);
@@ -5901,13 +6011,16 @@ void CanvasDock::stream_output_stop(void *data, calldata_t *calldata)
 				  Q_ARG(QString, stream_server), Q_ARG(QString, stream_key));
 }
 
-void CanvasDock::DestroyVideo()
+void CanvasDock::ResetVideo()
 {
+	// an idle canvas has no video mix, the next acquire picks up the new video info
 	if (!video)
 		return;
+	const uint32_t consumers = videoConsumers;
 	video = nullptr;
+	videoConsumers = 0;
 	obs_view_remove(view);
-	obs_view_set_source(view, 0, nullptr);
+	AcquireVideo(consumers);
 }
 
 obs_scene_t *CanvasDock::GetCurrentScene()
@@ -5946,7 +6059,7 @@ bool CanvasDock::RecordingActive()
 
 bool CanvasDock::BacktrackActive()
 {
-	return obs_output_active(replayOutput);
+	return obs_output_active(replayOutput) || (diskBacktrack && diskBacktrack->Active());
 }
 
 bool CanvasDock::VirtualCameraActive()
@@ -5954,6 +6067,119 @@ bool CanvasDock::VirtualCameraActive()
 	return obs_output_active(virtualCamOutput);
 }
 
+void CanvasDock::UpdateStats()
+{
+	CanvasStats ns;
+	if (video) {
+		ns.encoder_total_frames = video_output_get_total_frames(video);
+		ns.encoder_skipped_frames = video_output_get_skipped_frames(video);
+	}
+	ns.render_total_frames = obs_get_total_frames();
+	ns.render_lagged_frames = obs_get_lagged_frames();
+
+	const uint64_t now = os_gettime_ns();
+	auto sample = [&](obs_output_t *output, const char *type, std::string name) {
+		if (!output)
+			return;
+		OutputStats os;
+		os.output = output;
+		os.type = type;
+		os.name = name;
+		os.active = obs_output_active(output);
+		os.reconnecting = obs_output_reconnecting(output);
+		os.total_frames = obs_output_get_total_frames(output);
+		os.dropped_frames = obs_output_get_frames_dropped(output);
+		os.congestion = obs_output_get_congestion(output);
+		os.total_bytes = obs_output_get_total_bytes(output);
+		os.sample_time = now;
+		for (const auto &prev : stats.outputs) {
+			if (prev.output != output || !prev.sample_time || os.total_bytes < prev.total_bytes)
+				continue;
+			const uint64_t elapsed = now - prev.sample_time;
+			if (elapsed)
+				os.kbps = (double)(os.total_bytes - prev.total_bytes) * 8.0 * 1000000.0 / (double)elapsed;
+			break;
+		}
+		ns.outputs.push_back(os);
+	};
+
+	int idx = 0;
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		idx++;
+		sample(it->output, "stream",
+		       it->name.empty() ? std::string(obs_module_text("Output")) + " " + std::to_string(idx) : it->name);
+	}
+	sample(recordOutput, "record", obs_module_text("Recording"));
+	sample(diskBacktrack && replayDisk ? diskBacktrack->GetOutput() : replayOutput, "backtrack", obs_module_text("Backtrack"));
+	sample(virtualCamOutput, "virtual_camera", obs_module_text("VirtualCam"));
+
+	if (ns.encoder_total_frames >= stats.encoder_total_frames && stats.encoder_total_frames) {
+		metrics_ring_push(metrics.GetRing(CanvasMetric::OutputFrames),
+				  ns.encoder_total_frames - stats.encoder_total_frames);
+		metrics_ring_push(metrics.GetRing(CanvasMetric::SkippedFrames),
+				  ns.encoder_skipped_frames - stats.encoder_skipped_frames);
+	}
+	metrics.Collect();
+
+	{
+		std::unique_lock<std::mutex> lock(statsMutex);
+		stats = std::move(ns);
+	}
+	if (statsDock && statsDock->isVisible())
+		statsDock->Update(stats);
+
+	if (vendor && (vendor_event_mask & VENDOR_EVENT_STATS) && now - lastStatsEvent >= vendor_stats_interval_ns) {
+		lastStatsEvent = now;
+		const auto d = obs_data_create();
+		obs_data_set_string(d, "canvas_id", canvas_id.c_str());
+		obs_data_set_int(d, "width", canvas_width);
+		obs_data_set_int(d, "height", canvas_height);
+		GetStats(d);
+		obs_websocket_vendor_emit_event(vendor, "stats", d);
+		obs_data_release(d);
+	}
+}
+
+void CanvasDock::GetMetrics(obs_data_t *data, bool csv)
+{
+	if (csv) {
+		obs_data_set_string(data, "csv", metrics.ToCsv().c_str());
+	} else {
+		metrics.ToJson(data);
+	}
+}
+
+void CanvasDock::ResetMetrics()
+{
+	metrics.Reset();
+}
+
+void CanvasDock::GetStats(obs_data_t *data)
+{
+	std::unique_lock<std::mutex> lock(statsMutex);
+	obs_data_set_int(data, "encoder_total_frames", stats.encoder_total_frames);
+	obs_data_set_int(data, "encoder_skipped_frames", stats.encoder_skipped_frames);
+	obs_data_set_int(data, "render_total_frames", stats.render_total_frames);
+	obs_data_set_int(data, "render_lagged_frames", stats.render_lagged_frames);
+	auto outputs = obs_data_array_create();
+	for (const auto &os : stats.outputs) {
+		auto o = obs_data_create();
+		obs_data_set_string(o, "name", os.name.c_str());
+		obs_data_set_string(o, "type", os.type.c_str());
+		obs_data_set_bool(o, "active", os.active);
+		obs_data_set_bool(o, "reconnecting", os.reconnecting);
+		obs_data_set_int(o, "total_frames", os.total_frames);
+		obs_data_set_int(o, "dropped_frames", os.dropped_frames);
+		obs_data_set_double(o, "congestion", os.congestion);
+		obs_data_set_int(o, "total_bytes", (long long)os.total_bytes);
+		obs_data_set_double(o, "kbps", os.kbps);
+		obs_data_array_push_back(outputs, o);
+		obs_data_release(o);
+	}
+	obs_data_set_array(data, "outputs", outputs);
+	obs_data_array_release(outputs);
+}
+
 obs_data_t *CanvasDock::SaveSettings()
 {
 	auto data = obs_data_create();
@@ -5964,9 +6190,13 @@ obs_data_t *CanvasDock::SaveSettings()
 	if (scenesDock)
 		obs_data_set_bool(data, "grid_mode", scenesDock->IsGridMode());
 
+	obs_data_set_string(data, "canvas_id", canvas_id.c_str());
 	obs_data_set_int(data, "width", canvas_width);
 	obs_data_set_int(data, "height", canvas_height);
+	obs_data_set_int(data, "fps_divisor", fps_divisor);
 	obs_data_set_bool(data, "show_scenes", !hideScenes);
+	obs_data_set_bool(data, "render_cache", renderCache != nullptr);
+	obs_data_set_bool(data, "shared_texture", sharedTexture);
 	obs_data_set_bool(data, "preview_disabled", preview_disabled);
 	obs_data_set_bool(data, "virtual_cam_warned", virtual_cam_warned);
 	obs_data_set_int(data, "streaming_video_bitrate", streamingVideoBitrate);
@@ -5978,13 +6208,20 @@ obs_data_t *CanvasDock::SaveSettings()
 	obs_data_set_bool(data, "backtrack_always", replayAlwaysOn);
 	obs_data_set_int(data, "backtrack_seconds", replayDuration);
 	obs_data_set_string(data, "backtrack_path", replayPath.c_str());
+	obs_data_set_int(data, "backtrack_max_size_mb", replayMaxSize);
+	obs_data_set_bool(data, "backtrack_disk", replayDisk);
 	if (replayOutput) {
 		auto hotkeys = obs_hotkeys_save_output(replayOutput);
 		obs_data_set_obj(data, "backtrack_hotkeys", hotkeys);
 		obs_data_release(hotkeys);
+	} else if (replayHotkeys) {
+		obs_data_set_obj(data, "backtrack_hotkeys", replayHotkeys);
 	}
 
 	obs_data_set_int(data, "virtual_camera_mode", virtual_cam_mode);
+	obs_data_set_int(data, "virtual_camera_width", virtual_cam_width);
+	obs_data_set_int(data, "virtual_camera_height", virtual_cam_height);
+	obs_data_set_int(data, "virtual_camera_format", virtual_cam_format);
 
 	obs_data_array_t *stream_servers = obs_data_array_create();
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
@@ -6007,7 +6244,13 @@ obs_data_t *CanvasDock::SaveSettings()
 	obs_data_set_bool(data, "stream_advanced_settings", stream_advanced_settings);
 	obs_data_set_int(data, "stream_audio_track", stream_audio_track);
 	obs_data_set_string(data, "stream_encoder", stream_encoder.c_str());
-	obs_data_set_obj(data, "stream_encoder_settings", stream_encoder_settings);
+	if (stream_encoder_settings) {
+		// copy, the snapshot is serialized on the config writer thread
+		obs_data_t *ses = obs_data_create();
+		obs_data_apply(ses, stream_encoder_settings);
+		obs_data_set_obj(data, "stream_encoder_settings", ses);
+		obs_data_release(ses);
+	}
 
 	obs_data_set_string(data, "record_path", recordPath.c_str());
 	obs_data_set_bool(data, "record_advanced_settings", record_advanced_settings);
@@ -6015,7 +6258,12 @@ obs_data_t *CanvasDock::SaveSettings()
 	obs_data_set_string(data, "file_format", file_format.c_str());
 	obs_data_set_int(data, "record_audio_tracks", record_audio_tracks);
 	obs_data_set_string(data, "record_encoder", record_encoder.c_str());
-	obs_data_set_obj(data, "record_encoder_settings", record_encoder_settings);
+	if (record_encoder_settings) {
+		obs_data_t *res = obs_data_create();
+		obs_data_apply(res, record_encoder_settings);
+		obs_data_set_obj(data, "record_encoder_settings", res);
+		obs_data_release(res);
+	}
 
 	obs_data_array_t *start_hotkey = nullptr;
 	obs_data_array_t *stop_hotkey = nullptr;
@@ -6039,6 +6287,7 @@ obs_data_t *CanvasDock::SaveSettings()
 	obs_data_array_release(start_hotkey);
 	obs_data_array_release(stop_hotkey);
 
+	LoadDeferredTransitions();
 	obs_data_array_t *transition_array = obs_data_array_create();
 	for (auto transition : transitions) {
 		const char *id = obs_source_get_unversioned_id(transition);
@@ -6138,6 +6387,8 @@ void CanvasDock::LoadScenes()
 
 void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 {
+	// any switch replaces a queued one
+	switchTimer->stop();
 	auto s = scene_name.isEmpty() ? nullptr : obs_get_source_by_name(scene_name.toUtf8().constData());
 	if (s == obs_scene_get_source(scene) || (!obs_source_is_scene(s) && !scene_name.isEmpty())) {
 		obs_source_release(s);
@@ -6153,8 +6404,8 @@ void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 	if (!source || obs_weak_source_references_source(source, oldSource)) {
 		obs_weak_source_release(source);
 		source = obs_source_get_weak_source(s);
-		if (video && view)
-			obs_view_set_source(view, 0, s);
+		if (view)
+			SetViewSource(s);
 	} else {
 		oldSource = obs_weak_source_get_source(source);
 		if (oldSource) {
@@ -6187,15 +6438,15 @@ void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 			} else {
 				obs_weak_source_release(source);
 				source = obs_source_get_weak_source(s);
-				if (video && view)
-					obs_view_set_source(view, 0, s);
+				if (view)
+					SetViewSource(s);
 			}
 			obs_source_release(oldSource);
 		} else {
 			obs_weak_source_release(source);
 			source = obs_source_get_weak_source(s);
-			if (video && view)
-				obs_view_set_source(view, 0, s);
+			if (view)
+				SetViewSource(s);
 		}
 	}
 	scene = obs_scene_from_source(s);
@@ -6230,8 +6481,11 @@ void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 		sourcesDock->sourceList->GetStm()->SceneChanged();
 	}
 	obs_source_release(s);
-	if (vendor && oldName != currentSceneName) {
+	// the transition or view holds the new scene showing now
+	ReleasePrewarm();
+	if (vendor && (vendor_event_mask & VENDOR_EVENT_SCENE) && oldName != currentSceneName) {
 		const auto d = obs_data_create();
+		obs_data_set_string(d, "canvas_id", canvas_id.c_str());
 		obs_data_set_int(d, "width", canvas_width);
 		obs_data_set_int(d, "height", canvas_height);
 		obs_data_set_string(d, "old_scene", oldName.toUtf8().constData());
@@ -6241,6 +6495,41 @@ void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 	}
 }
 
+void CanvasDock::PrewarmScene(const QString &scene_name)
+{
+	obs_source_t *s = obs_get_source_by_name(scene_name.toUtf8().constData());
+	if (!s || !obs_source_is_scene(s) || s == obs_scene_get_source(scene) || s == prewarmSource) {
+		if (s && s == prewarmSource)
+			prewarmTimer->start(SCENE_PREWARM_TIMEOUT_MS);
+		obs_source_release(s);
+		return;
+	}
+	ReleasePrewarm();
+	// sources that load when shown, like browser and media sources, start
+	// loading now instead of in the middle of the transition
+	obs_source_inc_showing(s);
+	prewarmSource = s;
+	prewarmTimer->start(SCENE_PREWARM_TIMEOUT_MS);
+}
+
+void CanvasDock::QueueSwitchScene(const QString &scene_name, int delay_ms)
+{
+	PrewarmScene(scene_name);
+	pendingSwitchScene = scene_name;
+	switchTimer->start(delay_ms);
+}
+
+void CanvasDock::ReleasePrewarm()
+{
+	prewarmTimer->stop();
+	switchTimer->stop();
+	if (!prewarmSource)
+		return;
+	obs_source_dec_showing(prewarmSource);
+	obs_source_release(prewarmSource);
+	prewarmSource = nullptr;
+}
+
 void CanvasDock::transition_override_stop(void *data, calldata_t *)
 {
 	auto dock = (CanvasDock *)data;
@@ -6258,12 +6547,90 @@ obs_source_t *CanvasDock::GetTransition(const char *transition_name)
 {
 	if (!transition_name || !strlen(transition_name))
 		return nullptr;
-	for (auto transition : transitions) {
-		if (strcmp(transition_name, obs_source_get_name(transition)) == 0) {
-			return transition;
+	auto it = transitionIndex.find(transition_name);
+	if (it == transitionIndex.end() && deferredTransitions) {
+		LoadDeferredTransitions();
+		it = transitionIndex.find(transition_name);
+	}
+	return it == transitionIndex.end() ? nullptr : transitions[it->second].Get();
+}
+
+void CanvasDock::AddTransition(obs_source_t *transition)
+{
+	// sized once here so an override swaps in without touching the transition
+	obs_transition_set_size(transition, canvas_width, canvas_height);
+	transitionIndex[obs_source_get_name(transition)] = transitions.size();
+	transitions.emplace_back(transition);
+}
+
+void CanvasDock::RemoveTransition(obs_source_t *transition)
+{
+	// the deferred transitions are placed by name and position
+	LoadDeferredTransitions();
+	auto it = transitionIndex.find(obs_source_get_name(transition));
+	if (it == transitionIndex.end())
+		return;
+	const size_t idx = it->second;
+	transitionIndex.erase(it);
+	transitions.erase(transitions.begin() + idx);
+	// the transitions after the removed one moved down by one
+	for (auto &entry : transitionIndex) {
+		if (entry.second > idx)
+			entry.second--;
+	}
+	QueueSave();
+}
+
+void CanvasDock::RenameTransition(obs_source_t *transition, const char *name)
+{
+	LoadDeferredTransitions();
+	auto it = transitionIndex.find(obs_source_get_name(transition));
+	if (it == transitionIndex.end())
+		return;
+	const size_t idx = it->second;
+	transitionIndex.erase(it);
+	obs_source_set_name(transition, name);
+	transitionIndex[obs_source_get_name(transition)] = idx;
+	QueueSave();
+}
+
+void CanvasDock::LoadDeferredTransitions()
+{
+	if (!deferredTransitions)
+		return;
+	obs_data_array_t *transition_array = deferredTransitions;
+	deferredTransitions = nullptr;
+	// the array holds every saved transition in order, the one loaded up front is already in
+	// place and the others go in around it, transitions added since stay after them
+	size_t pos = deferredTransitionsPos;
+	size_t c = obs_data_array_count(transition_array);
+	for (size_t i = 0; i < c; i++) {
+		obs_data_t *td = obs_data_array_item(transition_array, i);
+		if (!td)
+			continue;
+		auto loaded = transitionIndex.find(obs_data_get_string(td, "name"));
+		if (loaded != transitionIndex.end() && loaded->second == pos) {
+			pos++;
+			obs_data_release(td);
+			continue;
+		}
+		OBSSourceAutoRelease transition = obs_load_private_source(td);
+		if (transition && pos <= transitions.size()) {
+			obs_transition_set_size(transition, canvas_width, canvas_height);
+			transitions.emplace(transitions.begin() + pos, transition.Get());
+			for (auto &entry : transitionIndex) {
+				if (entry.second >= pos)
+					entry.second++;
+			}
+			transitionIndex[obs_source_get_name(transition)] = pos;
+			if (transitionsDock)
+				transitionsDock->transition->insertItem((int)pos,
+									QString::fromUtf8(obs_source_get_name(transition)));
+			pos++;
 		}
+		obs_data_release(td);
 	}
-	return nullptr;
+	obs_data_array_release(transition_array);
 }
 
 bool CanvasDock::SwapTransition(obs_source_t *newTransition)
@@ -6271,15 +6638,18 @@ bool CanvasDock::SwapTransition(obs_source_t *newTransition)
 	if (!newTransition || obs_weak_source_references_source(source, newTransition))
 		return false;
 
-	obs_transition_set_size(newTransition, canvas_width, canvas_height);
+	uint32_t cx, cy;
+	obs_transition_get_size(newTransition, &cx, &cy);
+	if (cx != canvas_width || cy != canvas_height)
+		obs_transition_set_size(newTransition, canvas_width, canvas_height);
 
 	obs_source_t *oldTransition = obs_weak_source_get_source(source);
 	if (!oldTransition || obs_source_get_type(oldTransition) != OBS_SOURCE_TYPE_TRANSITION) {
 		obs_source_release(oldTransition);
 		obs_weak_source_release(source);
 		source = obs_source_get_weak_source(newTransition);
-		if (video && view)
-			obs_view_set_source(view, 0, newTransition);
+		if (view)
+			SetViewSource(newTransition);
 		obs_source_inc_showing(newTransition);
 		obs_source_inc_active(newTransition);
 		return true;
@@ -6291,8 +6661,8 @@ bool CanvasDock::SwapTransition(obs_source_t *newTransition)
 	obs_transition_swap_begin(newTransition, oldTransition);
 	obs_weak_source_release(source);
 	source = obs_source_get_weak_source(newTransition);
-	if (video && view)
-		obs_view_set_source(view, 0, newTransition);
+	if (view)
+		SetViewSource(newTransition);
 	obs_transition_swap_end(newTransition, oldTransition);
 	obs_source_dec_showing(oldTransition);
 	obs_source_dec_active(oldTransition);
@@ -6408,9 +6778,56 @@ void CanvasDock::source_save(void *data, calldata_t *calldata)
 	obs_data_release(settings);
 }
 
+void CanvasDock::EnsureReplayOutput()
+{
+	if (replayOutput)
+		return;
+	const QString replayName = QString::fromUtf8(obs_module_text("Vertical")) + " " +
+				   QString::fromUtf8(obs_module_text("Backtrack"));
+	replayOutput = obs_output_create("replay_buffer", replayName.toUtf8().constData(), nullptr, replayHotkeys);
+	obs_data_release(replayHotkeys);
+	replayHotkeys = nullptr;
+	auto rpsh = obs_output_get_signal_handler(replayOutput);
+	signal_handler_connect(rpsh, "saved", replay_saved, this);
+
+	// the replay buffer's own save hotkey only works while that output runs, it is replaced
+	// by one with the same name and bindings that saves the disk backtrack too
+	struct find_hotkey {
+		obs_output_t *output;
+		obs_hotkey_id id;
+		std::string description;
+	};
+	find_hotkey t = {replayOutput, OBS_INVALID_HOTKEY_ID, ""};
+	obs_enum_hotkeys(
+		[](void *data, obs_hotkey_id id, obs_hotkey_t *key) {
+			auto hp = (struct find_hotkey *)data;
+			if (obs_hotkey_get_registerer_type(key) != OBS_HOTKEY_REGISTERER_OUTPUT ||
+			    strcmp(obs_hotkey_get_name(key), "ReplayBuffer.Save") != 0)
+				return true;
+			obs_output_t *o = obs_weak_output_get_output((obs_weak_output_t *)obs_hotkey_get_registerer(key));
+			obs_output_release(o);
+			if (o != hp->output)
+				return true;
+			hp->id = id;
+			hp->description = obs_hotkey_get_description(key);
+			return false;
+		},
+		&t);
+	if (t.id == OBS_INVALID_HOTKEY_ID)
+		return;
+	obs_hotkey_unregister(t.id);
+	backtrack_hotkey = obs_hotkey_register_output(replayOutput, "ReplayBuffer.Save", t.description.c_str(),
+						      save_backtrack_hotkey, this);
+}
+
 void CanvasDock::FinishLoading()
 {
-	CheckReplayBuffer(true);
+	// the backtrack output with its hotkey and the encoders are created after the main window is up,
+	// each canvas in its own event loop pass
+	QTimer::singleShot(0, this, [this] {
+		EnsureReplayOutput();
+		CheckReplayBuffer(true);
+	});
 	if (!first_time)
 		return;
 	if (action && !action->isChecked())
@@ -6496,6 +6913,9 @@ void CanvasDock::OnRecordStart()
 
 void CanvasDock::TryRemux(QString path)
 {
+	// the frontend remux reads the codec from the main recording encoder,
+	// only hand the file over when that encoder already exists instead of
+	// starting and stopping the main outputs to create it
 	const obs_encoder_t *videoEncoder = nullptr;
 	obs_output_t *ro = obs_frontend_get_recording_output();
 	if (ro) {
@@ -6503,31 +6923,13 @@ void CanvasDock::TryRemux(QString path)
 		obs_output_release(ro);
 	}
 	if (!videoEncoder) {
-		if (!config_get_bool(obs_frontend_get_profile_config(), "Video", "AutoRemux"))
-			return;
-	}
-	if (!videoEncoder) {
-		obs_frontend_replay_buffer_start();
-		obs_frontend_replay_buffer_stop();
-		ro = obs_frontend_get_recording_output();
-		if (ro) {
-			videoEncoder = obs_output_get_video_encoder(ro);
-			obs_output_release(ro);
-		}
-	}
-	if (!videoEncoder) {
-		obs_frontend_recording_start();
-		obs_frontend_recording_stop();
-		ro = obs_frontend_get_recording_output();
-		if (ro) {
-			videoEncoder = obs_output_get_video_encoder(ro);
-			obs_output_release(ro);
-		}
-	}
-	if (videoEncoder) {
-		const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
-		QMetaObject::invokeMethod(main_window, "RecordingFileChanged", Q_ARG(QString, path));
+		if (config_get_bool(obs_frontend_get_profile_config(), "Video", "AutoRemux"))
+			blog(LOG_INFO, "[Vertical Canvas] not remuxing %s, main recording output has no encoder yet",
+			     path.toUtf8().constData());
+		return;
 	}
+	const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
+	QMetaObject::invokeMethod(main_window, "RecordingFileChanged", Q_ARG(QString, path));
 }
 
 void CanvasDock::OnRecordStop(int code, QString last_error)
@@ -6536,6 +6938,7 @@ void CanvasDock::OnRecordStop(int code, QString last_error)
 	recordButton->setIcon(recordInactiveIcon);
 	recordButton->setText("");
 	recordButton->setStyleSheet(QString::fromUtf8(""));
+	ReleaseVideo(VIDEO_CONSUMER_RECORD);
 	HandleRecordError(code, last_error);
 	CheckReplayBuffer();
 
@@ -6579,24 +6982,13 @@ void CanvasDock::HandleRecordError(int code, QString last_error)
 	}
 }
 
-void CanvasDock::OnReplaySaved()
+void CanvasDock::OnReplaySaved(QString saved_path)
 {
-	std::string path;
 	statusLabel->setText(QString::fromUtf8(obs_module_text("Saved")));
-	if (replayOutput) {
-		proc_handler_t *ph = obs_output_get_proc_handler(replayOutput);
-		if (ph) {
-			calldata_t cd = {0};
-			if (proc_handler_call(ph, "get_last_replay", &cd)) {
-				const char *p = calldata_string(&cd, "path");
-				if (p)
-					path = p;
-			}
-			calldata_free(&cd);
-		}
-	}
-	if (!path.empty())
-		TryRemux(QString::fromUtf8(path.c_str()));
+	// the memory backtrack is muxed straight into its final container, only
+	// the MPEG-TS clips of the disk backtrack can still need a remux
+	if (!saved_path.isEmpty())
+		TryRemux(saved_path);
 	replayStatusResetTimer.start(4000);
 }
 
@@ -6625,6 +7017,7 @@ void CanvasDock::OnStreamStop(int code, QString last_error, QString stream_serve
 		}
 	}
 	if (!active) {
+		ReleaseVideo(VIDEO_CONSUMER_STREAM);
 		streamButton->setChecked(false);
 		streamButton->setIcon(streamInactiveIcon);
 		streamButton->setText("");
@@ -6999,42 +7392,132 @@ void CanvasDock::AddSceneItem(OBSSceneItem item)
 	obs_scene_enum_items(scene, select_one, (obs_sceneitem_t *)item);
 }
 
-void CanvasDock::SendVendorEvent(const char *event_name)
+void CanvasDock::SendVendorEvent(const char *event_name, uint32_t category, obs_output_t *output, int code, const char *last_error)
 {
-	if (!vendor)
+	if (!vendor || !(vendor_event_mask & category))
 		return;
 	const auto d = obs_data_create();
+	obs_data_set_string(d, "canvas_id", canvas_id.c_str());
 	obs_data_set_int(d, "width", canvas_width);
 	obs_data_set_int(d, "height", canvas_height);
+	const char *state = strrchr(event_name, '_');
+	if (state)
+		obs_data_set_string(d, "state", state + 1);
+	if (output)
+		obs_data_set_string(d, "output", obs_output_get_name(output));
+	if (code != OBS_OUTPUT_SUCCESS) {
+		obs_data_set_int(d, "code", code);
+		if (last_error && strlen(last_error))
+			obs_data_set_string(d, "error", last_error);
+	}
 	obs_websocket_vendor_emit_event(vendor, event_name, d);
 	obs_data_release(d);
 }
 
-void CanvasDock::ResizeScenes()
+bool CanvasDock::SetResolution(uint32_t width, uint32_t height)
+{
+	if (!width || !height || (width == canvas_width && height == canvas_height))
+		return false;
+
+	// active stream and record outputs encode from a video mix with the old base
+	// size, a resized canvas would be cropped or offset in it until they stop
+	if (StreamingActive() || RecordingActive()) {
+		blog(LOG_WARNING, "[Vertical Canvas] resolution change to %ux%u refused while streaming or recording", width,
+		     height);
+		return false;
+	}
+
+	const uint64_t start = os_gettime_ns();
+	const uint32_t old_width = canvas_width;
+	const uint32_t old_height = canvas_height;
+	canvas_width = width;
+	canvas_height = height;
+
+	ResizeScenes(old_width, old_height);
+	auto t = obs_weak_source_get_source(source);
+	if (obs_source_get_type(t) == OBS_SOURCE_TYPE_TRANSITION)
+		obs_transition_set_size(t, width, height);
+	obs_source_release(t);
+	for (auto transition : transitions)
+		obs_transition_set_size(transition, width, height);
+	if (renderCache)
+		render_cache_source_set_size(obs_obj_get_data(renderCache), width, height);
+
+	// the scenes keep their names and order, so the scene lists stay as they are.
+	// The backtrack and virtual camera are stopped and restarted on a new mix,
+	// which also rebuilds the dedicated virtual camera mix at the new base size.
+	ProfileChanged();
+
+	blog(LOG_INFO, "[Vertical Canvas] resolution changed from %ux%u to %ux%u in %.1f ms", old_width, old_height, width,
+	     height, (double)(os_gettime_ns() - start) / 1000000.0);
+	return true;
+}
+
+void CanvasDock::ResizeScenes(uint32_t old_width, uint32_t old_height)
 {
+	// the combo and the scenes dock list the same scenes, resize each one once
+	QStringList names;
 	if (scenesCombo) {
-		for (int i = 0; i < scenesCombo->count(); i++) {
-			ResizeScene(scenesCombo->itemText(i));
-		}
+		for (int i = 0; i < scenesCombo->count(); i++)
+			names.append(scenesCombo->itemText(i));
 	}
 	if (scenesDock) {
-		for (int i = 0; i < scenesDock->sceneList->count(); i++) {
-			ResizeScene(scenesDock->sceneList->item(i)->text());
-		}
+		for (int i = 0; i < scenesDock->sceneList->count(); i++)
+			names.append(scenesDock->sceneList->item(i)->text());
+	}
+	names.removeDuplicates();
+
+	// reloading the current scene adds every item again, refresh the source list once afterwards
+	signal_handler_t *sh = scene ? obs_source_get_signal_handler(obs_scene_get_source(scene)) : nullptr;
+	if (sh)
+		signal_handler_disconnect(sh, "item_add", SceneItemAdded, this);
+
+	int resized = 0;
+	for (const auto &name : names) {
+		if (ResizeScene(name, old_width, old_height))
+			resized++;
+	}
+
+	if (sh)
+		signal_handler_connect(sh, "item_add", SceneItemAdded, this);
+	if (resized && sourcesDock)
+		sourcesDock->sourceList->RefreshItems();
+	blog(LOG_INFO, "[Vertical Canvas] resized %d of %d scenes to %ux%u", resized, (int)names.size(), canvas_width,
+	     canvas_height);
+}
+
+static void rescale_scene_items(obs_data_array_t *items, float sx, float sy)
+{
+	// positions follow each axis, sizes scale uniformly so items keep their aspect
+	const float s = sx < sy ? sx : sy;
+	const size_t count = obs_data_array_count(items);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(items, i);
+		struct vec2 v;
+		obs_data_get_vec2(item, "pos", &v);
+		vec2_set(&v, v.x * sx, v.y * sy);
+		obs_data_set_vec2(item, "pos", &v);
+		obs_data_get_vec2(item, "scale", &v);
+		vec2_mulf(&v, &v, s);
+		obs_data_set_vec2(item, "scale", &v);
+		obs_data_get_vec2(item, "bounds", &v);
+		vec2_mulf(&v, &v, s);
+		obs_data_set_vec2(item, "bounds", &v);
+		obs_data_release(item);
 	}
 }
 
-void CanvasDock::ResizeScene(QString scene_name)
+bool CanvasDock::ResizeScene(const QString &scene_name, uint32_t old_width, uint32_t old_height)
 {
 	if (scene_name.isEmpty())
-		return;
+		return false;
 	auto s = obs_get_source_by_name(scene_name.toUtf8().constData());
 	if (!s)
-		return;
+		return false;
 	auto scene = obs_scene_from_source(s);
-	if (!scene) {
+	if (!scene || (obs_source_get_width(s) == canvas_width && obs_source_get_height(s) == canvas_height)) {
 		obs_source_release(s);
-		return;
+		return false;
 	}
 	obs_scene_enum_items(
 		scene,
@@ -7047,6 +7530,12 @@ void CanvasDock::ResizeScene(QString scene_name)
 	auto data = obs_source_get_settings(s);
 	obs_data_set_int(data, "cx", canvas_width);
 	obs_data_set_int(data, "cy", canvas_height);
+	// rescale the items in the saved data so the single load below applies both
+	if (old_width && old_height) {
+		obs_data_array_t *items = obs_data_get_array(data, "items");
+		rescale_scene_items(items, (float)canvas_width / (float)old_width, (float)canvas_height / (float)old_height);
+		obs_data_array_release(items);
+	}
 	obs_source_load(s);
 	obs_data_release(data);
 	obs_scene_enum_items(
@@ -7057,6 +7546,7 @@ void CanvasDock::ResizeScene(QString scene_name)
 		},
 		nullptr);
 	obs_source_release(s);
+	return true;
 }
 
 static bool nudge_callback(obs_scene_t *, obs_sceneitem_t *item, void *param)
@@ -7138,20 +7628,28 @@ void CanvasDock::ProfileChanged()
 		restart_video = true;
 		return;
 	}
+	if (diskBacktrack && diskBacktrack->Active()) {
+		diskBacktrack->Stop();
+		restart_video = true;
+		return;
+	}
 
-	bool virtual_cam_active = obs_output_active(virtualCamOutput);
-	if (virtual_cam_active)
+	// the stop releases the virtual camera video, so restart once it arrived
+	if (obs_output_active(virtualCamOutput)) {
+		restart_virtual_cam = true;
 		StopVirtualCam();
+		return;
+	}
 
-	DestroyVideo();
-	StartVideo();
+	ResetVideo();
 
-	if (virtual_cam_active)
+	if (restart_virtual_cam)
 		StartVirtualCam();
 	if (restart_video)
 		StartReplayBuffer();
 
 	restart_video = false;
+	restart_virtual_cam = false;
 }
 
 void CanvasDock::DeleteProjector(OBSProjector *projector)
@@ -7348,6 +7846,7 @@ QMenu *CanvasDock::CreateVisibilityTransitionMenu(bool visible, obs_sceneitem_t
 void CanvasDock::get_transitions(void *data, struct obs_frontend_source_list *sources)
 {
 	auto dock = (CanvasDock *)data;
+	dock->LoadDeferredTransitions();
 	for (auto transition : dock->transitions) {
 		obs_source_t *tr = transition;
 		if (obs_source_get_ref(tr) != nullptr)
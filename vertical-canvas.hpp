@@ -2,6 +2,8 @@
 
 #include <mutex>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <obs-frontend-api.h>
 #include <QDockWidget>
 #include <qlistwidget.h>
@@ -15,23 +17,47 @@
 #include <graphics/vec2.h>
 #include <graphics/matrix4.h>
 
+#include "canvas-geometry.hpp"
+#include "canvas-metrics.hpp"
 #include "config-dialog.hpp"
+#include "disk-backtrack.hpp"
 #include "scenes-dock.hpp"
 #include "obs.hpp"
 #include "qt-display.hpp"
 #include "sources-dock.hpp"
 #include "projector.hpp"
-
-#define ITEM_LEFT (1 << 0)
-#define ITEM_RIGHT (1 << 1)
-#define ITEM_TOP (1 << 2)
-#define ITEM_BOTTOM (1 << 3)
-#define ITEM_ROT (1 << 4)
+#include "stats-dock.hpp"
 
 #define VIRTUAL_CAMERA_VERTICAL 0
 #define VIRTUAL_CAMERA_MAIN 1
 #define VIRTUAL_CAMERA_BOTH 2
 
+// the format the virtual camera output converts its frames to, a mix in any other
+// format gets converted again on the cpu. The linux camera takes YUY2, which the
+// gpu conversion does not produce.
+#if defined(_WIN32) || defined(__APPLE__)
+#define VIRTUAL_CAMERA_FORMAT VIDEO_FORMAT_NV12
+#else
+#define VIRTUAL_CAMERA_FORMAT VIDEO_FORMAT_NONE
+#endif
+
+#define VIDEO_CONSUMER_STREAM (1 << 0)
+#define VIDEO_CONSUMER_RECORD (1 << 1)
+#define VIDEO_CONSUMER_BACKTRACK (1 << 2)
+#define VIDEO_CONSUMER_VIRTUAL_CAM (1 << 3)
+
+#define VENDOR_EVENT_STREAMING (1 << 0)
+#define VENDOR_EVENT_RECORDING (1 << 1)
+#define VENDOR_EVENT_BACKTRACK (1 << 2)
+#define VENDOR_EVENT_VIRTUAL_CAMERA (1 << 3)
+#define VENDOR_EVENT_SCENE (1 << 4)
+#define VENDOR_EVENT_STATS (1 << 5)
+#define VENDOR_EVENT_ALL ((1 << 6) - 1)
+#define VENDOR_EVENT_DEFAULT (VENDOR_EVENT_ALL & ~VENDOR_EVENT_STATS)
+
+#define SCENE_PREWARM_MAX_MS 5000
+#define SCENE_PREWARM_TIMEOUT_MS 10000
+
 enum class ItemHandle : uint32_t {
 	None = 0,
 	TopLeft = ITEM_TOP | ITEM_LEFT,
@@ -62,6 +88,8 @@ public:
 class CanvasScenesDock;
 class CanvasSourcesDock;
 class CanvasTransitionsDock;
+class CanvasStatsDock;
+class LabelAtlas;
 class OBSProjector;
 
 class StreamServer {
@@ -79,6 +107,7 @@ class CanvasDock : public QFrame {
 	friend class CanvasScenesDock;
 	friend class CanvasSourcesDock;
 	friend class CanvasTransitionsDock;
+	friend class CanvasStatsDock;
 	friend class SourceTree;
 	friend class SourceTreeItem;
 	friend class SourceTreeModel;
@@ -96,6 +125,9 @@ private:
 	OBSWeakSource source;
 	obs_source_t *transitionAudioWrapper;
 	std::vector<OBSSource> transitions;
+	std::unordered_map<std::string, size_t> transitionIndex;
+	obs_data_array_t *deferredTransitions = nullptr;
+	size_t deferredTransitionsPos = 0;
 	std::vector<OBSProjector *> projectors;
 	std::unique_ptr<OBSEventFilter> eventFilter;
 
@@ -139,9 +171,18 @@ private:
 	obs_scene_t *scene = nullptr;
 	obs_view_t *view = nullptr;
 	video_t *video = nullptr;
+	uint32_t videoConsumers = 0;
 	obs_view_t *multiCanvasView = nullptr;
 	video_t *multiCanvasVideo = nullptr;
 	obs_source_t *multiCanvasSource = nullptr;
+	obs_view_t *virtualCamView = nullptr;
+	obs_source_t *renderCache = nullptr;
+	bool sharedTexture = false;
+	obs_source_t *prewarmSource = nullptr;
+	QTimer *prewarmTimer = nullptr;
+	QTimer *switchTimer = nullptr;
+	QString pendingSwitchScene;
+	video_t *virtualCamVideo = nullptr;
 	gs_texrender_t *texrender = nullptr;
 	gs_stagesurf_t *stagesurface = nullptr;
 	QPushButton *virtualCamButton;
@@ -152,6 +193,11 @@ private:
 	QLabel *statusLabel;
 	QTimer replayStatusResetTimer;
 	QTimer recordDurationTimer;
+	QTimer statsTimer;
+	CanvasStats stats;
+	std::mutex statsMutex;
+	uint64_t lastStatsEvent = 0;
+	CanvasMetrics metrics;
 	QPushButton *streamButton;
 	QPushButton *streamButtonMulti;
 	QIcon streamActiveIcon = QIcon(":/aitum/media/streaming.svg");
@@ -170,19 +216,28 @@ private:
 	QAction *sourcesDockAction = nullptr;
 	CanvasTransitionsDock *transitionsDock = nullptr;
 	QAction *transitionsDockAction = nullptr;
+	CanvasStatsDock *statsDock = nullptr;
+	QAction *statsDockAction = nullptr;
 	OBSBasicSettings *configDialog = nullptr;
 
 	obs_hotkey_pair_id stream_hotkey = OBS_INVALID_HOTKEY_PAIR_ID;
 	obs_hotkey_pair_id record_hotkey = OBS_INVALID_HOTKEY_PAIR_ID;
 	obs_hotkey_pair_id virtual_cam_hotkey = OBS_INVALID_HOTKEY_PAIR_ID;
+	obs_hotkey_id backtrack_hotkey = OBS_INVALID_HOTKEY_ID;
 
 	obs_output_t *virtualCamOutput = nullptr;
 	obs_output_t *recordOutput = nullptr;
 	obs_output_t *replayOutput = nullptr;
+	obs_data_t *replayHotkeys = nullptr;
+	std::unique_ptr<DiskBacktrack> diskBacktrack;
 
+	std::string canvas_id;
 	uint32_t canvas_width;
 	uint32_t canvas_height;
+	uint32_t fps_divisor = 1;
 	bool restart_video = false;
+	bool restart_virtual_cam = false;
+	static uint32_t backtrack_budget_mb;
 	bool hideScenes;
 	uint32_t streamingVideoBitrate;
 	uint32_t recordVideoBitrate;
@@ -192,6 +247,8 @@ private:
 	bool startReplay;
 	bool replayAlwaysOn;
 	uint32_t replayDuration;
+	uint32_t replayMaxSize = 0;
+	bool replayDisk = false;
 	std::string replayPath;
 	std::string replayFilename;
 
@@ -216,6 +273,9 @@ private:
 	obs_data_t *record_encoder_settings;
 	bool virtual_cam_warned;
 	uint32_t virtual_cam_mode = 0;
+	uint32_t virtual_cam_width = 0;
+	uint32_t virtual_cam_height = 0;
+	video_format virtual_cam_format = VIDEO_FORMAT_NONE;
 
 	QString currentSceneName;
 	bool first_time = false;
@@ -231,8 +291,7 @@ private:
 
 	gs_vertbuffer_t *box = nullptr;
 
-	OBSSourceAutoRelease spacerLabel[4];
-	int spacerPx[4] = {0};
+	std::unique_ptr<LabelAtlas> spacerAtlas;
 
 	inline bool IsFixedScaling() const { return fixedScaling; }
 
@@ -268,7 +327,6 @@ private:
 	void DrawSpacingHelpers(obs_scene_t *scene, float x, float y, float cx, float cy, float scale, float sourceX,
 				float sourceY);
 	void DrawSpacingLine(vec3 &start, vec3 &end, vec3 &viewport, float pixelRatio);
-	void SetLabelText(int sourceIndex, int px);
 	void RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, vec3 &viewport, float pixelRatio);
 	bool GetSourceRelativeXY(int mouseX, int mouseY, int &relX, int &relY);
 
@@ -281,8 +339,6 @@ private:
 	void SnapItemMovement(vec2 &offset);
 	void BoxItems(const vec2 &startPos, const vec2 &pos);
 	void GetStretchHandleData(const vec2 &pos, bool ignoreGroup);
-	void ClampAspect(vec3 &tl, vec3 &br, vec2 &size, const vec2 &baseSize);
-	vec3 CalculateStretchPos(const vec3 &tl, const vec3 &br);
 
 	bool DrawSelectionBox(float x1, float y1, float x2, float y2, gs_vertbuffer_t *rectFill);
 
@@ -298,7 +354,13 @@ private:
 
 	void AddSourceToScene(obs_source_t *source);
 
-	bool StartVideo();
+	video_t *AcquireVideo(uint32_t consumer);
+	void ReleaseVideo(uint32_t consumer);
+	video_t *AcquireVirtualCamVideo();
+	void ReleaseVirtualCamVideo();
+	void SetViewSource(obs_source_t *s);
+	void SetRenderCache(bool enable);
+	void RenderView();
 	void HandleRecordError(int code, QString last_error);
 
 	void CreateScenesRow();
@@ -307,16 +369,22 @@ private:
 	void SetLinkedScene(obs_source_t *scene, const QString &linkedScene);
 	bool HasScene(QString scene) const;
 	void CheckReplayBuffer(bool start = false);
-	void SendVendorEvent(const char *e);
+	void EnsureReplayOutput();
+	uint32_t GetReplayMaxSize();
+	void StartDiskBacktrack();
+	void SendVendorEvent(const char *e, uint32_t category, obs_output_t *output = nullptr, int code = OBS_OUTPUT_SUCCESS,
+			     const char *last_error = nullptr);
 	QListWidget *GetGlobalScenesList();
-	void ResizeScenes();
-	void ResizeScene(QString scene_name);
+	void ResizeScenes(uint32_t old_width, uint32_t old_height);
+	bool ResizeScene(const QString &scene_name, uint32_t old_width, uint32_t old_height);
 	void DeleteProjector(OBSProjector *projector);
 	OBSProjector *OpenProjector(int monitor);
 	void AddProjectorMenuMonitors(QMenu *parent, QObject *target, const char *slot);
 
 	void TryRemux(QString path);
+	void EnsureStreamService(std::vector<StreamServer>::iterator it);
 	void CreateStreamOutput(std::vector<StreamServer>::iterator it);
+	void UpdateStats();
 
 	void StreamButtonMultiMenu(QMenu *menu);
 
@@ -348,6 +416,7 @@ private:
 	static bool stop_recording_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
 	static bool start_streaming_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
 	static bool stop_streaming_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
+	static void save_backtrack_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 
 	static void SceneItemAdded(void *data, calldata_t *params);
 	static void SceneReordered(void *data, calldata_t *params);
@@ -368,13 +437,20 @@ private slots:
 	void OnVirtualCamStop();
 	void OnRecordStart();
 	void OnRecordStop(int code, QString last_error);
-	void OnReplaySaved();
+	void OnReplaySaved(QString path = QString());
 	void OnStreamStart();
 	void OnStreamStop(int code, QString last_error, QString stream_server, QString stream_key);
 	void OnReplayBufferStart();
 	void OnReplayBufferStop(int code, QString last_error);
 	void SwitchScene(const QString &scene_name, bool transition = true);
+	void PrewarmScene(const QString &scene_name);
+	void QueueSwitchScene(const QString &scene_name, int delay_ms);
+	void ReleasePrewarm();
 	obs_source_t *GetTransition(const char *transition_name);
+	void AddTransition(obs_source_t *transition);
+	void RemoveTransition(obs_source_t *transition);
+	void RenameTransition(obs_source_t *transition, const char *name);
+	void LoadDeferredTransitions();
 	bool SwapTransition(obs_source_t *transition);
 	void StartVirtualCam();
 	void StopVirtualCam();
@@ -392,7 +468,7 @@ private slots:
 	void AddSceneItem(OBSSceneItem item);
 	void RefreshSources(OBSScene scene);
 	void ReorderSources(OBSScene scene);
-	void DestroyVideo();
+	void ResetVideo();
 	void MainSceneChanged();
 	void MainStreamStart();
 	void MainStreamStop();
@@ -421,6 +497,7 @@ public:
 	void FinishLoading();
 	void setAction(QAction *action);
 	CanvasScenesDock *GetScenesDock();
+	inline const std::string &GetCanvasId() const { return canvas_id; }
 	inline uint32_t GetCanvasWidth() const { return canvas_width; }
 	inline uint32_t GetCanvasHeight() const { return canvas_height; }
 
@@ -432,6 +509,15 @@ public:
 	bool RecordingActive();
 	bool BacktrackActive();
 	bool VirtualCameraActive();
+	void GetStats(obs_data_t *data);
+	void GetMetrics(obs_data_t *data, bool csv);
+	void ResetMetrics();
+	bool SetResolution(uint32_t width, uint32_t height);
+
+	static inline uint32_t GetBacktrackBudget() { return backtrack_budget_mb; }
+	static void SetBacktrackBudget(uint32_t budget_mb);
+	static void UpdateBacktrackShares();
+	static void QueueSave();
 };
 
 class LockedCheckBox : public QCheckBox {